@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_input_behavior_accel
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <drivers/behavior.h>
+#include <zephyr/input/input.h>
+#include <zephyr/dt-bindings/input/input-event-codes.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/keymap.h>
+#include <zmk/behavior.h>
+
+// #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
+
+// gains are Q8, 256 is 1.0
+#define IB_ACCEL_GAIN_SHIFT 8
+#define IB_ACCEL_TABLE_SIZE 16
+
+// speeds are measured over at least one millisecond, and at most this window
+#define IB_ACCEL_MAX_WINDOW_MS 100
+
+enum accel_axis {
+    IB_ACCEL_AXIS_X,
+    IB_ACCEL_AXIS_Y,
+    IB_ACCEL_AXIS_WHEEL,
+    IB_ACCEL_AXIS_HWHEEL,
+    IB_ACCEL_AXIS_COUNT,
+};
+
+struct behavior_accel_data {
+    const struct device *dev;
+    int64_t window_start;
+    uint32_t window_counts;
+    // counts per second of the last complete window
+    uint32_t speed;
+    // sub-count remainder of each axis, carried to its next event
+    int32_t rem[IB_ACCEL_AXIS_COUNT];
+};
+
+struct behavior_accel_config {
+    int8_t evt_type;
+    int16_t input_code;
+    uint32_t speed_min;
+    uint32_t speed_step;
+    uint16_t gains[IB_ACCEL_TABLE_SIZE];
+};
+
+static int accel_axis(uint16_t code) {
+    switch (code) {
+    case INPUT_REL_X:
+        return IB_ACCEL_AXIS_X;
+    case INPUT_REL_Y:
+        return IB_ACCEL_AXIS_Y;
+    case INPUT_REL_WHEEL:
+        return IB_ACCEL_AXIS_WHEEL;
+    case INPUT_REL_HWHEEL:
+        return IB_ACCEL_AXIS_HWHEEL;
+    default:
+        return -1;
+    }
+}
+
+static void update_speed(struct behavior_accel_data *data, int64_t now, int32_t value) {
+    int64_t elapsed = now - data->window_start;
+    if (elapsed > 0) {
+        if (elapsed > IB_ACCEL_MAX_WINDOW_MS) {
+            // motion resumed after idle, the old window says nothing about current speed
+            data->speed = 0;
+        } else {
+            data->speed = data->window_counts * 1000 / (uint32_t)elapsed;
+        }
+        data->window_start = now;
+        data->window_counts = 0;
+    }
+    data->window_counts += value < 0 ? -value : value;
+}
+
+static uint16_t lookup_gain(const struct behavior_accel_config *config, uint32_t speed) {
+    if (speed <= config->speed_min) {
+        return config->gains[0];
+    }
+    uint32_t idx = (speed - config->speed_min) / config->speed_step;
+    return config->gains[MIN(idx, IB_ACCEL_TABLE_SIZE - 1)];
+}
+
+static int accel_keymap_binding_pressed(struct zmk_behavior_binding *binding,
+                                        struct zmk_behavior_binding_event event) {
+
+    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    struct behavior_accel_data *data = (struct behavior_accel_data *)dev->data;
+    const struct behavior_accel_config *config = dev->config;
+
+    struct input_event *evt = (struct input_event *)event.position;
+    if (config->evt_type >= 0 && evt->type != config->evt_type) {
+        return ZMK_BEHAVIOR_TRANSPARENT;
+    }
+    if (evt->type != INPUT_EV_REL) {
+        return ZMK_BEHAVIOR_TRANSPARENT;
+    }
+    if (config->input_code >= 0 && evt->code != config->input_code) {
+        return ZMK_BEHAVIOR_TRANSPARENT;
+    }
+    int axis = accel_axis(evt->code);
+    if (axis < 0 || !evt->value) {
+        return ZMK_BEHAVIOR_TRANSPARENT;
+    }
+
+    update_speed(data, event.timestamp, evt->value);
+
+    int32_t value = CLAMP(evt->value, INT16_MIN, INT16_MAX) *
+                        lookup_gain(config, data->speed) + data->rem[axis];
+    int32_t aval = value >> IB_ACCEL_GAIN_SHIFT;
+    data->rem[axis] = value - aval * (1 << IB_ACCEL_GAIN_SHIFT);
+    // LOG_DBG("speed %d > %d => %d", data->speed, evt->value, aval);
+
+    // a zero value keeps the event, and so its sync, flowing to the listener
+    evt->value = aval;
+    return ZMK_BEHAVIOR_TRANSPARENT;
+}
+
+static int input_behavior_accel_init(const struct device *dev) {
+    struct behavior_accel_data *data = dev->data;
+    data->dev = dev;
+    return 0;
+};
+
+static const struct behavior_driver_api behavior_accel_driver_api = {
+    .binding_pressed = accel_keymap_binding_pressed,
+};
+
+#define IBACC_POW(x, e) ((e) >= 3 ? (x) * (x) * (x) : (e) == 2 ? (x) * (x) : (x))
+
+// gain of table entry i in Q8, interpolated along (i / (size - 1)) ^ curve-exponent
+#define IBACC_GAIN(i, n)                                                                    \
+    ((DT_INST_PROP(n, gain_min) * 256 +                                                     \
+      (DT_INST_PROP(n, gain_max) - DT_INST_PROP(n, gain_min)) * 256 *                       \
+          IBACC_POW(i, DT_INST_PROP(n, curve_exponent)) /                                   \
+          IBACC_POW(IB_ACCEL_TABLE_SIZE - 1, DT_INST_PROP(n, curve_exponent))) /            \
+     100)
+
+#define IBACC_INST(n)                                                                       \
+    BUILD_ASSERT(DT_INST_PROP(n, speed_max) > DT_INST_PROP(n, speed_min),                   \
+                 "speed-max must be greater than speed-min");                               \
+    static struct behavior_accel_data behavior_accel_data_##n = {};                         \
+    static const struct behavior_accel_config behavior_accel_config_##n = {                 \
+        .evt_type = DT_INST_PROP(n, evt_type),                                              \
+        .input_code = DT_INST_PROP(n, input_code),                                          \
+        .speed_min = DT_INST_PROP(n, speed_min),                                            \
+        .speed_step = MAX(1, (DT_INST_PROP(n, speed_max) - DT_INST_PROP(n, speed_min)) /    \
+                                 (IB_ACCEL_TABLE_SIZE - 1)),                                \
+        .gains = {LISTIFY(IB_ACCEL_TABLE_SIZE, IBACC_GAIN, (, ), n)},                       \
+    };                                                                                      \
+    BEHAVIOR_DT_INST_DEFINE(n, input_behavior_accel_init, NULL,                             \
+                            &behavior_accel_data_##n,                                       \
+                            &behavior_accel_config_##n,                                     \
+                            POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,               \
+                            &behavior_accel_driver_api);
+
+DT_INST_FOREACH_STATUS_OKAY(IBACC_INST)
+
+// #endif /* DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT) */
@@ -15,6 +15,11 @@
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+#if IS_ENABLED(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+#endif
+#include <stdlib.h>
+
 // #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
 
 #include <zmk/endpoints.h>
@@ -23,6 +28,10 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/behavior.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/layer_state_changed.h>
+#if IS_ENABLED(CONFIG_ZMK_MOUSE_SMOOTH_SCROLLING) &&                                               \
+    !IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+#include <zmk/mouse/resolution_multipliers.h>
+#endif
 
 #ifndef ZMK_MOUSE_HID_NUM_BUTTONS
 #define ZMK_MOUSE_HID_NUM_BUTTONS 0x05
@@ -39,6 +48,38 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #define VALID_LISTENER_COUNT (DT_INST_FOREACH_STATUS_OKAY(ONE_IF_DEV_OK) 0)
 
+#define ONE_IF_CHILD_ROTATES(node_id, n) (DT_PROP_OR(node_id, rotate_deg, 0) != 0) +
+
+#define ONE_IF_FLOAT_ROTATION(n)                                                                   \
+    COND_CODE_1(DT_NODE_HAS_STATUS(DT_INST_PHANDLE(n, device), okay),                              \
+                ((!DT_INST_PROP(n, rotate_fixed_point) &&                                          \
+                  ((DT_INST_PROP(n, rotate_deg) != 0) +                                            \
+                   DT_INST_FOREACH_CHILD_VARGS(n, ONE_IF_CHILD_ROTATES, n) 0)) +),                 \
+                (0 +))
+
+// soft-float is only linked in when a listener still asks for float rotation
+#define FLOAT_ROTATION_COUNT (DT_INST_FOREACH_STATUS_OKAY(ONE_IF_FLOAT_ROTATION) 0)
+
+// Q15 sine of integer degrees as an integer constant expression, so the rotation
+// coefficients of each listener are computed from devicetree at build time.
+// The angle is folded into [0, 90] and evaluated with a 9th order Taylor series in Q30.
+#define IBL_DEG_NORM(d) ((((d) % 360) + 360) % 360)
+#define IBL_DEG_FOLD(d)                                                                            \
+    (IBL_DEG_NORM(d) % 180 > 90 ? 180 - IBL_DEG_NORM(d) % 180 : IBL_DEG_NORM(d) % 180)
+#define IBL_DEG_SIGN(d) (IBL_DEG_NORM(d) >= 180 ? -1 : 1)
+#define IBL_ONE_Q30 (1LL << 30)
+#define IBL_RAD_Q30(a) ((int64_t)(a) * 18740330LL) // pi / 180 in Q30
+#define IBL_SQ_Q30(r) (((r) * (r)) >> 30)
+#define IBL_SIN_H4(r2) (IBL_ONE_Q30 - (r2) / 72)
+#define IBL_SIN_H3(r2) (IBL_ONE_Q30 - (((r2) * IBL_SIN_H4(r2)) >> 30) / 42)
+#define IBL_SIN_H2(r2) (IBL_ONE_Q30 - (((r2) * IBL_SIN_H3(r2)) >> 30) / 20)
+#define IBL_SIN_H1(r2) (IBL_ONE_Q30 - (((r2) * IBL_SIN_H2(r2)) >> 30) / 6)
+#define IBL_SIN_Q30(r) (((r) * IBL_SIN_H1(IBL_SQ_Q30(r))) >> 30)
+#define IBL_SIN_Q15(d)                                                                             \
+    (IBL_DEG_SIGN(d) *                                                                             \
+     (int16_t)MIN((IBL_SIN_Q30(IBL_RAD_Q30(IBL_DEG_FOLD(d))) + (1 << 14)) >> 15, 32767))
+#define IBL_COS_Q15(d) IBL_SIN_Q15((d) + 90)
+
 #if VALID_LISTENER_COUNT > 0
 
 enum input_behavior_listener_xy_data_mode {
@@ -49,67 +90,349 @@ enum input_behavior_listener_xy_data_mode {
 
 struct input_behavior_listener_xy_data {
     enum input_behavior_listener_xy_data_mode mode;
-    int16_t x;
-    int16_t y;
+    int32_t x;
+    int32_t y;
+    // sub-count remainder of fixed-point rotation, carried to the next frame
+    int32_t x_rem;
+    int32_t y_rem;
+};
+
+struct input_behavior_listener_abs_axis {
+    int32_t pos;
+    int32_t last;
+    // remainder of scaling deltas, carried to the next frame
+    int32_t rem;
+    // last holds a position of the current touch
+    bool valid;
+    // pos was reported within the current sync frame
+    bool updated;
+};
+
+// absolute axes converted to relative motion, either as position deltas per sync
+// frame, or as joystick rate control emitted by rate_work while deflected
+struct input_behavior_listener_abs_data {
+    struct input_behavior_listener_abs_axis x;
+    struct input_behavior_listener_abs_axis y;
+    struct k_work_delayable rate_work;
+    struct input_behavior_listener_xy_data rate_data;
+    struct input_behavior_listener_xy_data rate_wheel_data;
+};
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS)
+struct input_behavior_listener_stats {
+    uint32_t events;
+    uint32_t intercepted;
+    uint32_t opaque;
+    uint32_t errors;
+    uint64_t cycles;
+    uint32_t cycles_max;
+    // frames and motion this listener contributed to the (possibly shared) report
+    uint32_t frames;
+    uint32_t motion;
+    uint32_t scroll;
+};
+
+struct input_behavior_listener_binding_stats {
+    uint32_t calls;
+    uint32_t opaque;
+    uint32_t errors;
+    uint64_t cycles;
+    uint32_t cycles_max;
+};
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PROFILING)
+struct input_behavior_listener_profile {
+    int64_t window_start;
+    bool frame_open;
+    uint32_t frame_start;
+    uint32_t events;
+    uint32_t frames;
+    uint64_t event_cycles;
+    uint32_t event_cycles_max;
+    uint64_t frame_cycles;
+    uint32_t frame_cycles_max;
+};
+#endif
+
+// events are dispatched by slot, each slot keeps a bitmask of the bindings which accept it
+enum input_behavior_listener_dispatch_slot {
+    INPUT_LISTENER_SLOT_REL_X,
+    INPUT_LISTENER_SLOT_REL_Y,
+    INPUT_LISTENER_SLOT_REL_HWHEEL,
+    INPUT_LISTENER_SLOT_REL_WHEEL,
+    INPUT_LISTENER_SLOT_REL_MISC,
+    INPUT_LISTENER_SLOT_REL_OTHER,
+    INPUT_LISTENER_SLOT_ABS,
+    INPUT_LISTENER_SLOT_KEY,
+    INPUT_LISTENER_SLOT_OTHER,
+    INPUT_LISTENER_SLOT_COUNT,
+};
+
+// (type, code) set a bound behavior accepts, read from its evt-type and input-code
+// properties in devicetree, -1 matches anything
+struct input_behavior_listener_binding_config {
+    struct zmk_behavior_binding binding;
+    int8_t evt_type;
+    int16_t input_code;
+};
+
+// range of movement and scroll values of a HID mouse report
+#define HID_MOVEMENT_MAX INT16_MAX
+#define HID_SCROLL_MAX INT8_MAX
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PREDICT)
+
+#define PREDICT_HISTORY CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PREDICT_HISTORY
+
+// frames older than this many report periods say nothing about the current velocity
+#define IBL_PREDICT_WINDOW_PERIODS 2
+
+struct input_behavior_listener_motion_sample {
+    int64_t time;
+    int32_t x;
+    int32_t y;
+};
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PREDICT)
+
+struct input_behavior_listener_report {
+    int32_t x;
+    int32_t y;
+    int32_t scroll_x;
+    int32_t scroll_y;
+    uint8_t button_set;
+    uint8_t button_clear;
+};
+
+// HID output of a listener, or of all listeners when the report is shared,
+// frames accumulate into the report until it is sent
+struct input_behavior_listener_output {
+    struct k_mutex lock;
+    struct k_work_delayable flush_work;
+    uint16_t period_ms;
+    int64_t last_sent;
+    bool pending;
+    struct input_behavior_listener_report report;
+    // reports which had motion beyond the HID range carried to the next report
+    uint32_t clipped;
+    // frames and reports not sent since they would not change the HID state
+    uint32_t suppressed;
+    // buttons held down as last reported
+    uint8_t buttons;
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PREDICT)
+    // largest extrapolated movement per axis, 0 disables prediction
+    uint16_t predict_max;
+    // movement reported ahead of the frames, taken back by the next report
+    int32_t predicted_x;
+    int32_t predicted_y;
+    // movement of the most recent frames, oldest overwritten first
+    uint8_t history_count;
+    uint8_t history_next;
+    struct input_behavior_listener_motion_sample history[PREDICT_HISTORY];
+#endif
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+    // listener device the processed frames are reported from
+    const struct device *dev;
+    // events the input subsystem could not take
+    uint32_t dropped;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS)
+    uint32_t reports;
+#endif
+};
+
+// binding resolved to its behavior device once at init, so the event path
+// neither looks up the behavior by name nor copies the binding
+struct input_behavior_listener_binding {
+    struct zmk_behavior_binding binding;
+    const struct device *dev;
+    const struct behavior_driver_api *api;
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS)
+    struct input_behavior_listener_binding_stats stats;
+#endif
+};
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_DEFERRED)
+
+#define RING_SIZE CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_DEFERRED_RING_SIZE
+BUILD_ASSERT(IS_POWER_OF_TWO(RING_SIZE), "Listener ring size must be a power of two");
+
+struct input_behavior_listener_record {
+    uint8_t type;
+    uint8_t sync;
+    uint16_t code;
+    int32_t value;
+};
+
+// single-producer/single-consumer ring, the input callback only moves head and
+// the listener thread only moves tail
+struct input_behavior_listener_ring {
+    atomic_t head;
+    atomic_t tail;
+    atomic_t overflows;
+    atomic_t high_water;
+    uint32_t overflows_reported;
+    struct input_behavior_listener_record records[RING_SIZE];
+};
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_DEFERRED)
+
+// transforms and bindings of a listener for the layers in layers_mask
+struct input_behavior_listener_layer_profile {
+    int8_t evt_type;
+    int8_t x_input_code;
+    int8_t y_input_code;
+    bool xy_swap;
+    bool x_invert;
+    bool y_invert;
+    uint16_t scale_multiplier;
+    uint16_t scale_divisor;
+    // scroll counts per wheel detent, 0 reports scroll counts as detents
+    uint16_t scroll_counts_per_detent;
+    uint16_t rotate_deg;
+    int16_t rotate_sin_q15;
+    int16_t rotate_cos_q15;
+    float rotate_sin;
+    float rotate_cos;
+    zmk_keymap_layers_state_t layers_mask;
+    uint8_t bindings_count;
+    const struct input_behavior_listener_binding_config *bindings;
+    // resolved bindings and their dispatch masks, shared with the listener node
+    // when a child profile has no bindings of its own
+    struct input_behavior_listener_binding *refs;
+    uint32_t *dispatch;
+};
+
+// fraction of a hi-res wheel unit not reported yet, in 1 / scroll-counts-per-detent,
+// for the resolution multiplier it was accumulated at
+struct input_behavior_listener_scroll {
+    int32_t x_rem;
+    int32_t y_rem;
+    uint8_t x_mul;
+    uint8_t y_mul;
 };
 
 struct input_behavior_listener_data {
+    const struct input_behavior_listener_config *config;
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_DEFERRED)
+    struct input_behavior_listener_ring ring;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS)
+    struct input_behavior_listener_stats stats;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PROFILING)
+    struct input_behavior_listener_profile profile;
+#endif
+    // cached result of the layers_mask of the profiles against the highest active
+    // layer, refreshed on layer_state_changed instead of on every input event
+    bool layer_enabled;
+    // profile of the highest active layer, kept on the last one while disabled
+    const struct input_behavior_listener_layer_profile *layer_profile;
+    struct input_behavior_listener_output *output;
+    struct input_behavior_listener_abs_data abs;
+    struct input_behavior_listener_scroll scroll;
     union {
         struct {
-            float sin;
-            float cos;
-
             struct input_behavior_listener_xy_data data;
             struct input_behavior_listener_xy_data wheel_data;
 
             uint8_t button_set;
             uint8_t button_clear;
+            // buttons of the current frame already went out on the fast path
+            bool fast_path_sent;
         } mouse;
     };
 };
 
 struct input_behavior_listener_config {
-    bool xy_swap;
-    bool x_invert;
-    bool y_invert;
-    uint16_t scale_multiplier;
-    uint16_t scale_divisor;
-    uint16_t rotate_deg;
-    int8_t evt_type;
-    int8_t x_input_code;
-    int8_t y_input_code;
-    uint8_t layers_count;
-    uint8_t layers[ZMK_KEYMAP_LAYERS_LEN];
-    uint8_t bindings_count;
-    struct zmk_behavior_binding bindings[];
+    const char *name;
+    const struct device *dev;
+    bool rotate_fixed_point;
+    bool abs_rate_control;
+    uint16_t abs_deadzone;
+    uint16_t abs_rate_period_ms;
+    int32_t abs_center_x;
+    int32_t abs_center_y;
+    bool button_fast_path;
+    // the listener node itself first, then its child nodes
+    uint8_t profiles_count;
+    const struct input_behavior_listener_layer_profile *profiles;
 };
 
-static void handle_rel_code(const struct input_behavior_listener_config *config,
-                            struct input_behavior_listener_data *data, struct input_event *evt) {
+static void accumulate_rel(struct input_behavior_listener_xy_data *data,
+                           struct input_behavior_listener_xy_data *wheel_data,
+                           const struct input_event *evt) {
     switch (evt->code) {
     case INPUT_REL_X:
-        data->mouse.data.mode = INPUT_LISTENER_XY_DATA_MODE_REL;
-        data->mouse.data.x += evt->value;
+        data->mode = INPUT_LISTENER_XY_DATA_MODE_REL;
+        data->x += evt->value;
         break;
     case INPUT_REL_Y:
-        data->mouse.data.mode = INPUT_LISTENER_XY_DATA_MODE_REL;
-        data->mouse.data.y += evt->value;
+        data->mode = INPUT_LISTENER_XY_DATA_MODE_REL;
+        data->y += evt->value;
         break;
     case INPUT_REL_WHEEL:
-        data->mouse.wheel_data.mode = INPUT_LISTENER_XY_DATA_MODE_REL;
-        data->mouse.wheel_data.y += evt->value;
+        wheel_data->mode = INPUT_LISTENER_XY_DATA_MODE_REL;
+        wheel_data->y += evt->value;
         break;
     case INPUT_REL_HWHEEL:
-        data->mouse.wheel_data.mode = INPUT_LISTENER_XY_DATA_MODE_REL;
-        data->mouse.wheel_data.x += evt->value;
+        wheel_data->mode = INPUT_LISTENER_XY_DATA_MODE_REL;
+        wheel_data->x += evt->value;
         break;
     default:
         break;
     }
 }
 
+static void handle_rel_code(const struct input_behavior_listener_config *config,
+                            struct input_behavior_listener_data *data, struct input_event *evt) {
+    accumulate_rel(&data->mouse.data, &data->mouse.wheel_data, evt);
+}
+
+static inline int32_t abs_rate_deflection(const struct input_behavior_listener_config *config,
+                                          int32_t pos, int32_t center) {
+    int32_t deflection = pos - center;
+    if (deflection > config->abs_deadzone) {
+        return deflection - config->abs_deadzone;
+    }
+    if (deflection < -config->abs_deadzone) {
+        return deflection + config->abs_deadzone;
+    }
+    return 0;
+}
+
 static void handle_abs_code(const struct input_behavior_listener_config *config,
-                            struct input_behavior_listener_data *data, struct input_event *evt) {}
+                            struct input_behavior_listener_data *data, struct input_event *evt) {
+    switch (evt->code) {
+    case INPUT_ABS_X:
+        data->abs.x.pos = evt->value;
+        data->abs.x.updated = true;
+        break;
+    case INPUT_ABS_Y:
+        data->abs.y.pos = evt->value;
+        data->abs.y.updated = true;
+        break;
+    default:
+        return;
+    }
+
+    if (!config->abs_rate_control) {
+        data->mouse.data.mode = INPUT_LISTENER_XY_DATA_MODE_ABS;
+        return;
+    }
+
+    if (abs_rate_deflection(config, data->abs.x.pos, config->abs_center_x) ||
+        abs_rate_deflection(config, data->abs.y.pos, config->abs_center_y)) {
+        // no-op while rate_work is already scheduled
+        k_work_schedule(&data->abs.rate_work, K_NO_WAIT);
+    }
+}
+
+static void reset_abs_data(struct input_behavior_listener_data *data) {
+    data->abs.x.valid = data->abs.y.valid = false;
+    data->abs.x.rem = data->abs.y.rem = 0;
+}
 
 static void handle_key_code(const struct input_behavior_listener_config *config,
                             struct input_behavior_listener_data *data, struct input_event *evt) {
@@ -128,6 +451,10 @@ static void handle_key_code(const struct input_behavior_listener_config *config,
             WRITE_BIT(data->mouse.button_clear, btn, 1);
         }
         break;
+    case INPUT_BTN_TOUCH:
+        // the next touch starts from its own position instead of jumping from the last one
+        reset_abs_data(data);
+        break;
     default:
         break;
     }
@@ -150,6 +477,66 @@ static void swap_xy(struct input_event *evt) {
     }
 }
 
+static enum input_behavior_listener_dispatch_slot dispatch_slot(const struct input_event *evt) {
+    switch (evt->type) {
+    case INPUT_EV_REL:
+        switch (evt->code) {
+        case INPUT_REL_X:
+            return INPUT_LISTENER_SLOT_REL_X;
+        case INPUT_REL_Y:
+            return INPUT_LISTENER_SLOT_REL_Y;
+        case INPUT_REL_HWHEEL:
+            return INPUT_LISTENER_SLOT_REL_HWHEEL;
+        case INPUT_REL_WHEEL:
+            return INPUT_LISTENER_SLOT_REL_WHEEL;
+        case INPUT_REL_MISC:
+            return INPUT_LISTENER_SLOT_REL_MISC;
+        default:
+            return INPUT_LISTENER_SLOT_REL_OTHER;
+        }
+    case INPUT_EV_ABS:
+        return INPUT_LISTENER_SLOT_ABS;
+    case INPUT_EV_KEY:
+        return INPUT_LISTENER_SLOT_KEY;
+    default:
+        return INPUT_LISTENER_SLOT_OTHER;
+    }
+}
+
+#if !IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+
+static const struct {
+    int8_t type;
+    int16_t code;
+} dispatch_slots[INPUT_LISTENER_SLOT_COUNT] = {
+    [INPUT_LISTENER_SLOT_REL_X] = {INPUT_EV_REL, INPUT_REL_X},
+    [INPUT_LISTENER_SLOT_REL_Y] = {INPUT_EV_REL, INPUT_REL_Y},
+    [INPUT_LISTENER_SLOT_REL_HWHEEL] = {INPUT_EV_REL, INPUT_REL_HWHEEL},
+    [INPUT_LISTENER_SLOT_REL_WHEEL] = {INPUT_EV_REL, INPUT_REL_WHEEL},
+    [INPUT_LISTENER_SLOT_REL_MISC] = {INPUT_EV_REL, INPUT_REL_MISC},
+    [INPUT_LISTENER_SLOT_REL_OTHER] = {INPUT_EV_REL, -1},
+    [INPUT_LISTENER_SLOT_ABS] = {INPUT_EV_ABS, -1},
+    [INPUT_LISTENER_SLOT_KEY] = {INPUT_EV_KEY, -1},
+    [INPUT_LISTENER_SLOT_OTHER] = {-1, -1},
+};
+
+// catch-all slots are accepted by any filter of a matching type, so the table may
+// over-include a binding but never skips one; behaviors still check the exact code
+static bool dispatch_slot_accepts(enum input_behavior_listener_dispatch_slot slot,
+                                  const struct input_behavior_listener_binding_config *cfg) {
+    if (cfg->evt_type >= 0 && dispatch_slots[slot].type >= 0 &&
+        cfg->evt_type != dispatch_slots[slot].type) {
+        return false;
+    }
+    if (cfg->input_code >= 0 && dispatch_slots[slot].code >= 0 &&
+        cfg->input_code != dispatch_slots[slot].code) {
+        return false;
+    }
+    return true;
+}
+
+#endif // !IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+
 static inline bool is_x_data(const struct input_event *evt) {
     return evt->type == INPUT_EV_REL && (evt->code == INPUT_REL_X || evt->code == INPUT_REL_HWHEEL);
 }
@@ -158,64 +545,120 @@ static inline bool is_y_data(const struct input_event *evt) {
     return evt->type == INPUT_EV_REL && (evt->code == INPUT_REL_Y || evt->code == INPUT_REL_WHEEL);
 }
 
-static bool intercept_with_input_config(const struct input_behavior_listener_config *cfg,
-                                        struct input_event *evt) {
-    if (!evt->dev) {
-        return false;
-    }
+static uint8_t active_layer;
 
-    uint8_t layer = zmk_keymap_highest_layer_active();
-    bool active_layer_check = false;
-    for (uint8_t i = 0; i < cfg->layers_count && !active_layer_check; i++) {
-        active_layer_check |= layer == cfg->layers[i];
-    }
-    if (!active_layer_check) {
-        return false;
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS)
+
+static void update_binding_stats(struct input_behavior_listener_stats *stats,
+                                 struct input_behavior_listener_binding_stats *binding_stats,
+                                 int ret, uint32_t cycles) {
+    binding_stats->calls++;
+    binding_stats->cycles += cycles;
+    binding_stats->cycles_max = MAX(binding_stats->cycles_max, cycles);
+    if (ret == ZMK_BEHAVIOR_OPAQUE) {
+        binding_stats->opaque++;
+        stats->opaque++;
+    } else if (ret < 0) {
+        binding_stats->errors++;
+        stats->errors++;
     }
+}
 
-    if (cfg->evt_type >= 0 && evt->type == cfg->evt_type) {
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS)
+
+// Remap, swap, invert and scale a relative event as configured for the active profile.
+static void transform_rel_event(const struct input_behavior_listener_layer_profile *prof,
+                                struct input_event *evt, bool scale) {
+    if (prof->evt_type >= 0 && evt->type == prof->evt_type) {
         if ((evt->code == INPUT_REL_X) || (evt->code == INPUT_REL_HWHEEL)) {
-            if (cfg->x_input_code >= 0) {
-                evt->code = cfg->x_input_code;
+            if (prof->x_input_code >= 0) {
+                evt->code = prof->x_input_code;
             }
         }
         else if ((evt->code == INPUT_REL_Y) || (evt->code == INPUT_REL_WHEEL)) {
-            if (cfg->y_input_code >= 0) {
-                evt->code = cfg->y_input_code;
+            if (prof->y_input_code >= 0) {
+                evt->code = prof->y_input_code;
             }
         }
     }
 
-    if (cfg->xy_swap) {
+    if (prof->xy_swap) {
         swap_xy(evt);
     }
 
-    if ((cfg->x_invert && is_x_data(evt)) || (cfg->y_invert && is_y_data(evt))) {
+    if ((prof->x_invert && is_x_data(evt)) || (prof->y_invert && is_y_data(evt))) {
         evt->value = -(evt->value);
     }
 
-    evt->value = (int16_t)((evt->value * cfg->scale_multiplier) / cfg->scale_divisor);
+    if (scale) {
+        // sensor deltas fit in 16 bits, which keeps the product of any scale-multiplier in 32 bits
+        evt->value = CLAMP(evt->value, INT16_MIN, INT16_MAX) * prof->scale_multiplier /
+                     prof->scale_divisor;
+    }
+}
+
+// A listener without child profiles always uses its own.
+static inline const struct input_behavior_listener_layer_profile *
+active_profile(const struct input_behavior_listener_config *config,
+               const struct input_behavior_listener_data *data) {
+    return config->profiles_count == 1 ? &config->profiles[0] : data->layer_profile;
+}
+
+static bool resolve_binding(struct input_behavior_listener_binding *ref) {
+    const struct device *behavior = zmk_behavior_get_binding(ref->binding.behavior_dev);
+    if (!behavior) {
+        return false;
+    }
+    ref->dev = behavior;
+    ref->api = (const struct behavior_driver_api *)behavior->api;
+    return true;
+}
+
+static bool intercept_with_input_config(const struct input_behavior_listener_config *cfg,
+                                        struct input_behavior_listener_data *data,
+                                        struct input_event *evt) {
+    if (!evt->dev) {
+        return false;
+    }
+
+    if (!data->layer_enabled) {
+        return false;
+    }
+    uint8_t layer = active_layer;
+    const struct input_behavior_listener_layer_profile *prof = active_profile(cfg, data);
+
+    if (evt->type == INPUT_EV_REL) {
+        transform_rel_event(prof, evt, true);
+    }
 
     bool to_be_intercapted = true;
 
-    for (uint8_t b = 0; b < cfg->bindings_count; b++) {
-        struct zmk_behavior_binding binding = cfg->bindings[b];
-        // LOG_DBG("layer: %d input: %s, binding name: %s", layer, evt->dev->name, binding.behavior_dev);
+    uint32_t pending = prof->dispatch[dispatch_slot(evt)];
+    while (pending) {
+        uint8_t b = find_lsb_set(pending) - 1;
+        pending &= pending - 1;
 
-        const struct device *behavior = zmk_behavior_get_binding(binding.behavior_dev);
-        if (!behavior) {
+        struct input_behavior_listener_binding *ref = &prof->refs[b];
+        struct zmk_behavior_binding *binding = &ref->binding;
+        // LOG_DBG("layer: %d input: %s, binding name: %s", layer, evt->dev->name, binding->behavior_dev);
+
+        // fallback for behaviors which were not ready when the listener was initialized
+        if (!ref->api && !resolve_binding(ref)) {
             LOG_WRN("No behavior assigned to %s on layer %d", evt->dev->name, layer);
             continue;
         }
 
-        const struct behavior_driver_api *api = (const struct behavior_driver_api *)behavior->api;
+        const struct behavior_driver_api *api = ref->api;
         int ret = ZMK_BEHAVIOR_TRANSPARENT;
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS)
+        uint32_t binding_start = k_cycle_get_32();
+#endif
 
         if (api->binding_pressed || api->binding_released) {
 
             struct zmk_behavior_binding_event event = {
                 .layer = layer, .timestamp = k_uptime_get(),
-                .position = (struct input_event *)evt, // util uint32_t to pass event ptr :)
+                .position = (uintptr_t)evt, // util uint32_t to pass event ptr :)
             };
 
             bool state = true;
@@ -226,10 +669,10 @@ static bool intercept_with_input_config(const struct input_behavior_listener_con
             }
 
             if (api->binding_pressed && state) {
-                ret = api->binding_pressed(&binding, event);
+                ret = api->binding_pressed(binding, event);
             }
             else if (api->binding_released && !state) {
-                ret = api->binding_released(&binding, event);
+                ret = api->binding_released(binding, event);
             }
 
         }
@@ -243,22 +686,26 @@ static bool intercept_with_input_config(const struct input_behavior_listener_con
                 const struct zmk_sensor_config *sensor_config = 
                     (const struct zmk_sensor_config *)cfg;
                 const struct zmk_sensor_channel_data val[] = {
-                    { .value = { .val1 = (struct input_event *)evt },
+                    { .value = { .val1 = (intptr_t)evt },
                     .channel = SENSOR_CHAN_ALL, },
                 };
-                int ret = behavior_sensor_keymap_binding_accept_data(
-                    &binding, event, sensor_config, sizeof(val), val);
+                int ret = api->sensor_binding_accept_data(
+                    binding, event, sensor_config, sizeof(val), val);
                 if (ret < 0) {
                     LOG_WRN("behavior data accept for behavior %s returned an error (%d). "
-                            "Processing to continue to next layer",  binding.behavior_dev, ret);
+                            "Processing to continue to next layer",  binding->behavior_dev, ret);
                 }
             }
             enum behavior_sensor_binding_process_mode mode =
                     BEHAVIOR_SENSOR_BINDING_PROCESS_MODE_TRIGGER;
-            ret = behavior_sensor_keymap_binding_process(&binding, event, mode);
+            ret = api->sensor_binding_process(binding, event, mode);
 
         }
 
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS)
+        update_binding_stats(&data->stats, &ref->stats, ret, k_cycle_get_32() - binding_start);
+#endif
+
         if (ret == ZMK_BEHAVIOR_OPAQUE) {
             // LOG_DBG("input event processing complete, behavior response was opaque");
             to_be_intercapted = false;
@@ -267,141 +714,1372 @@ static bool intercept_with_input_config(const struct input_behavior_listener_con
             // LOG_DBG("input behavior returned error: %d", ret);
             return ret;
         }
+
+        // a binding changed the layer inline (e.g. tog-layer with activate-immediately),
+        // gate the rest of this event on the new layer and hand it to the bindings of its
+        // profile, the transform of the old profile is not undone or applied again
+        if (active_layer != layer) {
+            if (!data->layer_enabled) {
+                return false;
+            }
+            layer = active_layer;
+            const struct input_behavior_listener_layer_profile *next = active_profile(cfg, data);
+            if (next->refs != prof->refs) {
+                pending = next->dispatch[dispatch_slot(evt)];
+            }
+            prof = next;
+        }
     }
 
     return to_be_intercapted;
 }
 
-static void clear_xy_data(struct input_behavior_listener_xy_data *data) {
-    data->x = data->y = 0;
-    data->mode = INPUT_LISTENER_XY_DATA_MODE_NONE;
+static void rotate_xy_data(const struct input_behavior_listener_config *config,
+                           const struct input_behavior_listener_layer_profile *prof,
+                           struct input_behavior_listener_xy_data *data) {
+    if (config->rotate_fixed_point) {
+        int64_t x = data->x;
+        int64_t y = data->y;
+        int64_t rx = (x * prof->rotate_cos_q15) - (y * prof->rotate_sin_q15) + data->x_rem;
+        int64_t ry = (x * prof->rotate_sin_q15) + (y * prof->rotate_cos_q15) + data->y_rem;
+        int32_t ox = (rx + (1 << 14)) >> 15;
+        int32_t oy = (ry + (1 << 14)) >> 15;
+        data->x_rem = rx - (int64_t)ox * (1 << 15);
+        data->y_rem = ry - (int64_t)oy * (1 << 15);
+        data->x = ox;
+        data->y = oy;
+        return;
+    }
+#if FLOAT_ROTATION_COUNT > 0
+    float x = data->x;
+    float y = data->y;
+    data->x = (prof->rotate_cos * x) - (prof->rotate_sin * y);
+    data->y = (prof->rotate_sin * x) + (prof->rotate_cos * y);
+#endif
 }
 
-static void input_behavior_handler(const struct input_behavior_listener_config *config,
-                                   struct input_behavior_listener_data *data, 
-                                   struct input_event *evt) {
-    // First, filter to update the event data as needed.
-    if (!intercept_with_input_config(config, evt)) {
+// Rotate the movement and scroll of a whole sync frame in one pass.
+static void rotate_frame(const struct input_behavior_listener_config *config,
+                         const struct input_behavior_listener_layer_profile *prof,
+                         struct input_behavior_listener_xy_data *data,
+                         struct input_behavior_listener_xy_data *wheel_data) {
+    if (prof->rotate_deg == 0) {
         return;
     }
+    if (data->mode == INPUT_LISTENER_XY_DATA_MODE_REL) {
+        rotate_xy_data(config, prof, data);
+    }
+    if (wheel_data->mode == INPUT_LISTENER_XY_DATA_MODE_REL) {
+        rotate_xy_data(config, prof, wheel_data);
+    }
+}
 
-    switch (evt->type) {
-    case INPUT_EV_REL:
-        handle_rel_code(config, data, evt);
-        break;
-    case INPUT_EV_ABS:
-        handle_abs_code(config, data, evt);
-        break;
-    case INPUT_EV_KEY:
-        handle_key_code(config, data, evt);
-        break;
+#if !IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+
+// Convert scroll counts of one axis to wheel units at mul units per detent, keeping
+// the fraction of a unit in *rem. A new multiplier drops the fraction of the old one.
+static int32_t scroll_units(int32_t *rem, uint8_t *last_mul, int32_t counts,
+                            uint16_t counts_per_detent, uint8_t mul) {
+    if (*last_mul != mul) {
+        *last_mul = mul;
+        *rem = 0;
     }
+    int32_t acc = *rem + CLAMP(counts, INT16_MIN, INT16_MAX) * mul;
+    int32_t units = acc / counts_per_detent;
+    *rem = acc - units * counts_per_detent;
+    return units;
+}
 
-    if (evt->sync) {
-        if (data->mouse.wheel_data.mode == INPUT_LISTENER_XY_DATA_MODE_REL) {
-            if (config->rotate_deg > 0) {
-                float x = data->mouse.wheel_data.x;
-                float y = data->mouse.wheel_data.y;
-                data->mouse.wheel_data.x = (data->mouse.cos * x) - (data->mouse.sin * y);
-                data->mouse.wheel_data.y = (data->mouse.sin * x) + (data->mouse.cos * y);
-            }
-            #if IS_ENABLED(CONFIG_ZMK_MOUSE)
-                zmk_hid_mouse_scroll_set(data->mouse.wheel_data.x, data->mouse.wheel_data.y);
-            #endif
+// Report the scroll of a frame in hi-res wheel units when the host enabled the
+// resolution multiplier of the HID descriptor, otherwise in whole detents.
+static void scale_scroll_frame(const struct input_behavior_listener_layer_profile *prof,
+                               struct input_behavior_listener_data *data,
+                               struct input_behavior_listener_xy_data *wheel_data) {
+    if (!prof->scroll_counts_per_detent || wheel_data->mode != INPUT_LISTENER_XY_DATA_MODE_REL) {
+        return;
+    }
+
+    uint8_t x_mul = 1, y_mul = 1;
+#if IS_ENABLED(CONFIG_ZMK_MOUSE_SMOOTH_SCROLLING)
+    // the host writes the logical value, 0 to 15 for a multiplier of 1 to 16
+    struct zmk_mouse_resolution_multipliers mult =
+        zmk_mouse_resolution_multipliers_get_current_profile();
+    x_mul = mult.hor_wheel + 1;
+    y_mul = mult.wheel + 1;
+#endif
+
+    struct input_behavior_listener_scroll *scroll = &data->scroll;
+    wheel_data->x = scroll_units(&scroll->x_rem, &scroll->x_mul, wheel_data->x,
+                                 prof->scroll_counts_per_detent, x_mul);
+    wheel_data->y = scroll_units(&scroll->y_rem, &scroll->y_mul, wheel_data->y,
+                                 prof->scroll_counts_per_detent, y_mul);
+}
+
+#endif // !IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+
+static inline bool has_rel_data(const struct input_behavior_listener_xy_data *data) {
+    return data->mode == INPUT_LISTENER_XY_DATA_MODE_REL && (data->x || data->y);
+}
+
+static void clear_xy_data(struct input_behavior_listener_xy_data *data) {
+    data->x = data->y = 0;
+    data->mode = INPUT_LISTENER_XY_DATA_MODE_NONE;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+
+// Report the processed frame as input events of the listener device, which the split
+// input forwarder of the peripheral sends to the central in one go.
+static void forward_report(struct input_behavior_listener_output *output,
+                           const struct input_behavior_listener_report *report) {
+    struct {
+        uint8_t type;
+        uint16_t code;
+        int32_t value;
+    } evts[4 + 2 * ZMK_MOUSE_HID_NUM_BUTTONS];
+    size_t count = 0;
+
+#define IBL_FORWARD(t, c, v)                                                                       \
+    evts[count++] = (typeof(evts[0])) { .type = (t), .code = (c), .value = (v) }
+
+    if (report->x) {
+        IBL_FORWARD(INPUT_EV_REL, INPUT_REL_X, report->x);
+    }
+    if (report->y) {
+        IBL_FORWARD(INPUT_EV_REL, INPUT_REL_Y, report->y);
+    }
+    if (report->scroll_x) {
+        IBL_FORWARD(INPUT_EV_REL, INPUT_REL_HWHEEL, report->scroll_x);
+    }
+    if (report->scroll_y) {
+        IBL_FORWARD(INPUT_EV_REL, INPUT_REL_WHEEL, report->scroll_y);
+    }
+    for (int i = 0; i < ZMK_MOUSE_HID_NUM_BUTTONS; i++) {
+        if ((report->button_set & BIT(i)) != 0) {
+            IBL_FORWARD(INPUT_EV_KEY, INPUT_BTN_0 + i, 1);
+        }
+    }
+    for (int i = 0; i < ZMK_MOUSE_HID_NUM_BUTTONS; i++) {
+        if ((report->button_clear & BIT(i)) != 0) {
+            IBL_FORWARD(INPUT_EV_KEY, INPUT_BTN_0 + i, 0);
         }
+    }
 
-        if (data->mouse.data.mode == INPUT_LISTENER_XY_DATA_MODE_REL) {
-            if (config->rotate_deg > 0) {
-                float x = data->mouse.data.x;
-                float y = data->mouse.data.y;
-                data->mouse.data.x = (data->mouse.cos * x) - (data->mouse.sin * y);
-                data->mouse.data.y = (data->mouse.sin * x) + (data->mouse.cos * y);
-            }
-            #if IS_ENABLED(CONFIG_ZMK_MOUSE)
-                zmk_hid_mouse_movement_set(data->mouse.data.x, data->mouse.data.y);
-            #endif
+#undef IBL_FORWARD
+
+    for (size_t i = 0; i < count; i++) {
+        // never block, the caller may run on the input thread which drains the queue
+        int ret = input_report(output->dev, evts[i].type, evts[i].code, evts[i].value,
+                               i == count - 1, K_NO_WAIT);
+        if (ret < 0) {
+            output->dropped++;
+            LOG_WRN("%s: input event dropped (%d)", output->dev->name, ret);
         }
+    }
+}
 
-        if (data->mouse.button_set != 0) {
-            for (int i = 0; i < ZMK_MOUSE_HID_NUM_BUTTONS; i++) {
-                if ((data->mouse.button_set & BIT(i)) != 0) {
-                    #if IS_ENABLED(CONFIG_ZMK_MOUSE)
-                        zmk_hid_mouse_button_press(i);
-                    #endif
-                }
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+
+#if !IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL) && IS_ENABLED(CONFIG_ZMK_MOUSE)
+
+// The zmk_hid_mouse_* report is one for the whole keyboard, while the outputs are sent
+// from the input thread, the listener thread, the flush and rate work of the system
+// workqueue. Each set, send and clear runs under this lock, so one output never clears
+// motion another one has set but not sent yet.
+static K_MUTEX_DEFINE(hid_mouse_lock);
+
+#endif
+
+static void send_report(struct input_behavior_listener_output *output,
+                        const struct input_behavior_listener_report *report) {
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+    forward_report(output, report);
+#elif IS_ENABLED(CONFIG_ZMK_MOUSE)
+    k_mutex_lock(&hid_mouse_lock, K_FOREVER);
+    zmk_hid_mouse_scroll_set(report->scroll_x, report->scroll_y);
+    zmk_hid_mouse_movement_set(report->x, report->y);
+
+    if (report->button_set != 0) {
+        for (int i = 0; i < ZMK_MOUSE_HID_NUM_BUTTONS; i++) {
+            if ((report->button_set & BIT(i)) != 0) {
+                zmk_hid_mouse_button_press(i);
             }
         }
+    }
 
-        if (data->mouse.button_clear != 0) {
-            for (int i = 0; i < ZMK_MOUSE_HID_NUM_BUTTONS; i++) {
-                if ((data->mouse.button_clear & BIT(i)) != 0) {
-                    #if IS_ENABLED(CONFIG_ZMK_MOUSE)
-                        zmk_hid_mouse_button_release(i);
-                    #endif
-                }
+    if (report->button_clear != 0) {
+        for (int i = 0; i < ZMK_MOUSE_HID_NUM_BUTTONS; i++) {
+            if ((report->button_clear & BIT(i)) != 0) {
+                zmk_hid_mouse_button_release(i);
             }
         }
+    }
+
+    zmk_endpoints_send_mouse_report();
+    zmk_hid_mouse_scroll_set(0, 0);
+    zmk_hid_mouse_movement_set(0, 0);
+    k_mutex_unlock(&hid_mouse_lock);
+#endif
+}
 
-        #if IS_ENABLED(CONFIG_ZMK_MOUSE)
-            zmk_endpoints_send_mouse_report();
-            zmk_hid_mouse_scroll_set(0, 0);
-            zmk_hid_mouse_movement_set(0, 0);
-        #endif
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PREDICT)
+
+// Keep the movement of a frame for the velocity estimate, expects the output lock held.
+static void record_motion(struct input_behavior_listener_output *output, int64_t now,
+                          int32_t x, int32_t y) {
+    output->history[output->history_next] =
+        (struct input_behavior_listener_motion_sample){.time = now, .x = x, .y = y};
+    output->history_next = (output->history_next + 1) % PREDICT_HISTORY;
+    output->history_count = MIN(output->history_count + 1, PREDICT_HISTORY);
+}
 
-        clear_xy_data(&data->mouse.data);
-        clear_xy_data(&data->mouse.wheel_data);
+// Velocity in Q8 counts per millisecond over the frames of the recent window, zero once
+// no frame arrived for a whole report period. The oldest frame only marks the start of
+// the span, its movement happened before it.
+static void estimate_velocity(const struct input_behavior_listener_output *output, int64_t now,
+                              int32_t *vx, int32_t *vy) {
+    int64_t window = (int64_t)IBL_PREDICT_WINDOW_PERIODS * output->period_ms;
+    const struct input_behavior_listener_motion_sample *first = NULL;
+    int64_t last = INT64_MIN;
+    int32_t sx = 0, sy = 0;
 
-        data->mouse.button_set = data->mouse.button_clear = 0;
+    *vx = *vy = 0;
+    for (uint8_t i = 0; i < output->history_count; i++) {
+        const struct input_behavior_listener_motion_sample *sample = &output->history[i];
+        if (now - sample->time > window) {
+            continue;
+        }
+        sx += sample->x;
+        sy += sample->y;
+        if (!first || sample->time < first->time) {
+            first = sample;
+        }
+        last = MAX(last, sample->time);
+    }
+    if (!first || last <= first->time || now - last >= output->period_ms) {
+        return;
     }
+
+    int32_t span = (int32_t)(last - first->time);
+    *vx = (int32_t)((int64_t)(sx - first->x) * 256 / span);
+    *vy = (int32_t)((int64_t)(sy - first->y) * 256 / span);
 }
 
-#endif // VALID_LISTENER_COUNT > 0
+// Add the movement expected until the next report to the pending report, and take back
+// what the previous report predicted, so an overshoot is undone by the next report.
+static void predict_motion(struct input_behavior_listener_output *output, int64_t now) {
+    int32_t vx, vy;
+    estimate_velocity(output, now, &vx, &vy);
 
-#define IBL_EXTRACT_BINDING(idx, drv_inst)                                                         \
-    {                                                                                              \
-        .behavior_dev = DEVICE_DT_NAME(DT_INST_PHANDLE_BY_IDX(drv_inst, bindings, idx)),           \
-        .param1 = COND_CODE_0(DT_INST_PHA_HAS_CELL_AT_IDX(drv_inst, bindings, idx, param1), (0),   \
-                              (DT_INST_PHA_BY_IDX(drv_inst, bindings, idx, param1))),              \
-        .param2 = COND_CODE_0(DT_INST_PHA_HAS_CELL_AT_IDX(drv_inst, bindings, idx, param2), (0),   \
-                              (DT_INST_PHA_BY_IDX(drv_inst, bindings, idx, param2))),              \
+    int32_t max = output->predict_max;
+    int32_t px = (int32_t)CLAMP((int64_t)vx * output->period_ms / 256, -max, max);
+    int32_t py = (int32_t)CLAMP((int64_t)vy * output->period_ms / 256, -max, max);
+
+    output->report.x += px - output->predicted_x;
+    output->report.y += py - output->predicted_y;
+    output->predicted_x = px;
+    output->predicted_y = py;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PREDICT)
+
+// Move what fits into one HID report out of the pending accumulators. Motion beyond
+// the report range stays pending and is carried into the following reports.
+static bool take_report(struct input_behavior_listener_output *output,
+                        struct input_behavior_listener_report *report) {
+    struct input_behavior_listener_report *pending = &output->report;
+
+    *report = (struct input_behavior_listener_report){
+        .x = CLAMP(pending->x, -HID_MOVEMENT_MAX, HID_MOVEMENT_MAX),
+        .y = CLAMP(pending->y, -HID_MOVEMENT_MAX, HID_MOVEMENT_MAX),
+        .scroll_x = CLAMP(pending->scroll_x, -HID_SCROLL_MAX, HID_SCROLL_MAX),
+        .scroll_y = CLAMP(pending->scroll_y, -HID_SCROLL_MAX, HID_SCROLL_MAX),
+        .button_set = pending->button_set,
+        .button_clear = pending->button_clear,
+    };
+
+    pending->x -= report->x;
+    pending->y -= report->y;
+    pending->scroll_x -= report->scroll_x;
+    pending->scroll_y -= report->scroll_y;
+    pending->button_set = pending->button_clear = 0;
+
+    bool carry = pending->x || pending->y || pending->scroll_x || pending->scroll_y;
+    if (carry) {
+        output->clipped++;
     }
+    return carry;
+}
 
-#define IBL_INST(n)                                                                                \
-    COND_CODE_1(                                                                                   \
-        DT_NODE_HAS_STATUS(DT_INST_PHANDLE(n, device), okay),                                      \
-        (static const struct input_behavior_listener_config config_##n = {                         \
-            .xy_swap = DT_INST_PROP(n, xy_swap),                                                   \
-            .x_invert = DT_INST_PROP(n, x_invert),                                                 \
-            .y_invert = DT_INST_PROP(n, y_invert),                                                 \
-            .scale_multiplier = DT_INST_PROP(n, scale_multiplier),                                 \
-            .scale_divisor = DT_INST_PROP(n, scale_divisor),                                       \
-            .rotate_deg = DT_INST_PROP(n, rotate_deg),                                             \
-            .evt_type = DT_INST_PROP(n, evt_type),                                                 \
-            .x_input_code = DT_INST_PROP(n, x_input_code),                                         \
-            .y_input_code = DT_INST_PROP(n, y_input_code),                                         \
-            .layers_count = DT_INST_PROP_LEN(n, layers),                                           \
-            .layers = DT_INST_PROP(n, layers),                                                     \
-            .bindings_count = COND_CODE_1(                                                         \
-                DT_INST_NODE_HAS_PROP(n, bindings),                                                \
-                (DT_INST_PROP_LEN(n, bindings)), (0)),                                             \
-            .bindings = COND_CODE_1(                                                               \
-                DT_INST_NODE_HAS_PROP(n, bindings),                                                \
-                ({LISTIFY(DT_INST_PROP_LEN(n, bindings), IBL_EXTRACT_BINDING, (, ), n)}),          \
-                ({})),                                                                             \
-        };                                                                                         \
-        static struct input_behavior_listener_data data_##n = {                                    \
-            .mouse = {                                                                             \
-                .sin = sinf((DT_INST_PROP(n, rotate_deg) * M_PI / 180.0f)),                        \
-                .cos = cosf((DT_INST_PROP(n, rotate_deg) * M_PI / 180.0f)),                        \
-            },                                                                                     \
-        };                                                                                         \
-        void input_behavior_handler_##n(struct input_event *evt) {                                 \
-            input_behavior_handler(&config_##n, &data_##n, evt);                                   \
-        }                                                                                          \
-        INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(DT_INST_PHANDLE(n, device)),                           \
-                             input_behavior_handler_##n);),                                        \
-        ())
+// Drop button changes which the host already has, a press and release of the same
+// button within one report are both kept. Returns false when nothing is left to send.
+static bool filter_report(struct input_behavior_listener_output *output,
+                          struct input_behavior_listener_report *report) {
+    report->button_set &= ~output->buttons;
+    report->button_clear &= output->buttons | report->button_set;
+    output->buttons = (output->buttons | report->button_set) & ~report->button_clear;
 
-DT_INST_FOREACH_STATUS_OKAY(IBL_INST)
+    return report->x || report->y || report->scroll_x || report->scroll_y ||
+           report->button_set || report->button_clear;
+}
+
+// Send the report unless it would not change anything, expects the output lock held
+// so the button state of the output matches the order its reports are sent in.
+static void send_output_report(struct input_behavior_listener_output *output,
+                               struct input_behavior_listener_report *report) {
+    if (!filter_report(output, report)) {
+        output->suppressed++;
+        return;
+    }
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS)
+    output->reports++;
+#endif
+    send_report(output, report);
+}
+
+// Send what is pending in the output, expects the output lock held. Returns true when
+// motion is left over for another report.
+static bool flush_pending(struct input_behavior_listener_output *output) {
+    if (!output->pending) {
+        return false;
+    }
+
+    struct input_behavior_listener_report report;
+    int64_t now = k_uptime_get();
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PREDICT)
+    if (output->predict_max && output->period_ms) {
+        predict_motion(output, now);
+    }
+#endif
+    bool carry = take_report(output, &report);
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PREDICT)
+    // a prediction is settled by the next report, even if no frame arrives until then
+    carry = carry || output->predicted_x || output->predicted_y;
+#endif
+    output->pending = carry;
+    output->last_sent = now;
+    send_output_report(output, &report);
+    return carry;
+}
+
+static void flush_output(struct input_behavior_listener_output *output) {
+    k_mutex_lock(&output->lock, K_FOREVER);
+    bool carry = flush_pending(output);
+    k_mutex_unlock(&output->lock);
+
+    if (carry) {
+        k_work_schedule(&output->flush_work, K_MSEC(MAX(output->period_ms, 1)));
+    }
+}
+
+// Send a button change right away, in its own report after one with the motion pending
+// in the output, so motion made before the change still reaches the host before it.
+static void send_buttons(struct input_behavior_listener_output *output, uint8_t button_set,
+                         uint8_t button_clear) {
+    struct input_behavior_listener_report report = {
+        .button_set = button_set,
+        .button_clear = button_clear,
+    };
+
+    k_mutex_lock(&output->lock, K_FOREVER);
+    bool carry = flush_pending(output);
+    send_output_report(output, &report);
+    k_mutex_unlock(&output->lock);
+
+    if (carry) {
+        k_work_schedule(&output->flush_work, K_MSEC(MAX(output->period_ms, 1)));
+    }
+}
+
+static void flush_output_work_cb(struct k_work *work) {
+    struct k_work_delayable *work_delayable = k_work_delayable_from_work(work);
+    struct input_behavior_listener_output *output =
+        CONTAINER_OF(work_delayable, struct input_behavior_listener_output, flush_work);
+    flush_output(output);
+}
+
+// Add the finished sync frame to the pending report. Without a report period, or when
+// buttons changed, the report is sent right away, otherwise motion coalesces until the
+// period since the last report has elapsed.
+static void submit_frame(struct input_behavior_listener_output *output,
+                         const struct input_behavior_listener_xy_data *data,
+                         const struct input_behavior_listener_xy_data *wheel_data,
+                         uint8_t button_set, uint8_t button_clear) {
+    bool buttons = button_set || button_clear;
+    bool motion = has_rel_data(data);
+    bool scroll = has_rel_data(wheel_data);
+
+    k_mutex_lock(&output->lock, K_FOREVER);
+    if (!buttons && !motion && !scroll) {
+        // e.g. all motion of the frame was held back by a scaler
+        output->suppressed++;
+        k_mutex_unlock(&output->lock);
+        return;
+    }
+    int64_t now = k_uptime_get();
+    if (data->mode == INPUT_LISTENER_XY_DATA_MODE_REL) {
+        output->report.x += data->x;
+        output->report.y += data->y;
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PREDICT)
+        record_motion(output, now, data->x, data->y);
+#endif
+    }
+    if (wheel_data->mode == INPUT_LISTENER_XY_DATA_MODE_REL) {
+        output->report.scroll_x += wheel_data->x;
+        output->report.scroll_y += wheel_data->y;
+    }
+    output->report.button_set |= button_set;
+    output->report.button_clear |= button_clear;
+    output->pending = true;
+    int64_t wait_ms = output->period_ms - (now - output->last_sent);
+    k_mutex_unlock(&output->lock);
+
+    if (buttons || wait_ms <= 0) {
+        flush_output(output);
+    } else {
+        // no-op while a flush is already scheduled
+        k_work_schedule(&output->flush_work, K_MSEC(wait_ms));
+    }
+}
+
+// Submit a frame of the listener to its output, counting what each source
+// contributed when several listeners share one report.
+static void submit_listener_frame(struct input_behavior_listener_data *data,
+                                  const struct input_behavior_listener_xy_data *xy_data,
+                                  const struct input_behavior_listener_xy_data *wheel_data,
+                                  uint8_t button_set, uint8_t button_clear) {
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS)
+    data->stats.frames++;
+    if (xy_data->mode == INPUT_LISTENER_XY_DATA_MODE_REL) {
+        data->stats.motion += abs(xy_data->x) + abs(xy_data->y);
+    }
+    if (wheel_data->mode == INPUT_LISTENER_XY_DATA_MODE_REL) {
+        data->stats.scroll += abs(wheel_data->x) + abs(wheel_data->y);
+    }
+#endif
+    submit_frame(data->output, xy_data, wheel_data, button_set, button_clear);
+}
+
+static int32_t scale_abs_delta(const struct input_behavior_listener_layer_profile *prof,
+                               struct input_behavior_listener_abs_axis *axis, int32_t delta) {
+    int32_t value = CLAMP(delta, INT16_MIN, INT16_MAX) * prof->scale_multiplier + axis->rem;
+    int32_t scaled = value / prof->scale_divisor;
+    axis->rem = value - scaled * prof->scale_divisor;
+    return scaled;
+}
+
+// Feed scaled deltas of both absolute axes through the relative transform, so
+// remapping, swapping and inverting apply to touchpads and joysticks as well.
+static void accumulate_abs_deltas(const struct input_behavior_listener_config *config,
+                                  const struct input_behavior_listener_layer_profile *prof,
+                                  struct input_behavior_listener_xy_data *data,
+                                  struct input_behavior_listener_xy_data *wheel_data,
+                                  int32_t dx, int32_t dy) {
+    struct input_event evt = {.dev = config->dev, .type = INPUT_EV_REL};
+
+    if (dx) {
+        evt.code = INPUT_REL_X;
+        evt.value = dx;
+        transform_rel_event(prof, &evt, false);
+        accumulate_rel(data, wheel_data, &evt);
+    }
+    if (dy) {
+        evt.code = INPUT_REL_Y;
+        evt.value = dy;
+        transform_rel_event(prof, &evt, false);
+        accumulate_rel(data, wheel_data, &evt);
+    }
+}
+
+static int32_t abs_axis_delta(const struct input_behavior_listener_layer_profile *prof,
+                              struct input_behavior_listener_abs_axis *axis) {
+    if (!axis->updated) {
+        return 0;
+    }
+    axis->updated = false;
+    if (!axis->valid) {
+        axis->valid = true;
+        axis->last = axis->pos;
+        return 0;
+    }
+    int32_t delta = axis->pos - axis->last;
+    axis->last = axis->pos;
+    return scale_abs_delta(prof, axis, delta);
+}
+
+static void abs_to_rel(const struct input_behavior_listener_config *config,
+                       struct input_behavior_listener_data *data) {
+    const struct input_behavior_listener_layer_profile *prof = active_profile(config, data);
+    int32_t dx = abs_axis_delta(prof, &data->abs.x);
+    int32_t dy = abs_axis_delta(prof, &data->abs.y);
+
+    data->mouse.data.mode = INPUT_LISTENER_XY_DATA_MODE_NONE;
+    accumulate_abs_deltas(config, prof, &data->mouse.data, &data->mouse.wheel_data, dx, dy);
+}
+
+// Joystick rate control, moves by the deflection beyond the deadzone every
+// abs-rate-period-ms for as long as the stick is held.
+static void abs_rate_work_cb(struct k_work *work) {
+    struct k_work_delayable *work_delayable = k_work_delayable_from_work(work);
+    struct input_behavior_listener_abs_data *abs =
+        CONTAINER_OF(work_delayable, struct input_behavior_listener_abs_data, rate_work);
+    struct input_behavior_listener_data *data =
+        CONTAINER_OF(abs, struct input_behavior_listener_data, abs);
+    const struct input_behavior_listener_config *config = data->config;
+
+    int32_t dx = abs_rate_deflection(config, abs->x.pos, config->abs_center_x);
+    int32_t dy = abs_rate_deflection(config, abs->y.pos, config->abs_center_y);
+    if ((!dx && !dy) || !data->layer_enabled) {
+        // stopped until the next deflecting event
+        abs->x.rem = abs->y.rem = 0;
+        return;
+    }
+
+    const struct input_behavior_listener_layer_profile *prof = active_profile(config, data);
+    dx = scale_abs_delta(prof, &abs->x, dx);
+    dy = scale_abs_delta(prof, &abs->y, dy);
+    accumulate_abs_deltas(config, prof, &abs->rate_data, &abs->rate_wheel_data, dx, dy);
+    rotate_frame(config, prof, &abs->rate_data, &abs->rate_wheel_data);
+#if !IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+    scale_scroll_frame(prof, data, &abs->rate_wheel_data);
+#endif
+    submit_listener_frame(data, &abs->rate_data, &abs->rate_wheel_data, 0, 0);
+    clear_xy_data(&abs->rate_data);
+    clear_xy_data(&abs->rate_wheel_data);
+
+    k_work_schedule(&abs->rate_work, K_MSEC(config->abs_rate_period_ms));
+}
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_RECORDER)
+
+#define RECORDER_SIZE CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_RECORDER_SIZE
+
+enum input_behavior_listener_record_stage {
+    IBL_RECORD_RAW,
+    IBL_RECORD_INTERCEPTED,
+};
+
+struct input_behavior_listener_capture {
+    uint32_t ticks;
+    const struct input_behavior_listener_config *config;
+    uint16_t code;
+    uint8_t type;
+    uint8_t stage : 1;
+    uint8_t sync : 1;
+    int32_t value;
+};
+
+static struct {
+    struct k_spinlock lock;
+    atomic_t enabled;
+    // total records written, the oldest one is overwritten once the ring is full
+    uint32_t count;
+    struct input_behavior_listener_capture records[RECORDER_SIZE];
+} recorder;
+
+static void record_event(const struct input_behavior_listener_config *config,
+                         const struct input_event *evt,
+                         enum input_behavior_listener_record_stage stage) {
+    if (!atomic_get(&recorder.enabled)) {
+        return;
+    }
+
+    uint32_t ticks = (uint32_t)k_uptime_ticks();
+    k_spinlock_key_t key = k_spin_lock(&recorder.lock);
+    recorder.records[recorder.count % RECORDER_SIZE] = (struct input_behavior_listener_capture){
+        .ticks = ticks,
+        .config = config,
+        .code = evt->code,
+        .type = evt->type,
+        .stage = stage,
+        .sync = evt->sync,
+        .value = evt->value,
+    };
+    recorder.count++;
+    k_spin_unlock(&recorder.lock, key);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_RECORDER)
+
+// Rotate the frame accumulated so far and submit it with its buttons.
+static void submit_current_frame(const struct input_behavior_listener_config *config,
+                                 struct input_behavior_listener_data *data) {
+    const struct input_behavior_listener_layer_profile *prof = active_profile(config, data);
+    rotate_frame(config, prof, &data->mouse.data, &data->mouse.wheel_data);
+#if !IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+    scale_scroll_frame(prof, data, &data->mouse.wheel_data);
+#endif
+
+    // the sync of a frame whose buttons went out on the fast path has nothing left to
+    // send, which is not a report to count as suppressed
+    if (!data->mouse.fast_path_sent || has_rel_data(&data->mouse.data) ||
+        has_rel_data(&data->mouse.wheel_data) || data->mouse.button_set ||
+        data->mouse.button_clear) {
+        submit_listener_frame(data, &data->mouse.data, &data->mouse.wheel_data,
+                              data->mouse.button_set, data->mouse.button_clear);
+    }
+
+    clear_xy_data(&data->mouse.data);
+    clear_xy_data(&data->mouse.wheel_data);
+
+    data->mouse.button_set = data->mouse.button_clear = 0;
+    data->mouse.fast_path_sent = false;
+}
+
+// Send a button change without waiting for the sync of its frame. Relative motion of
+// the frame which came before the button is submitted first, as a frame of its own, so
+// the end of a drag is not cut short.
+static void send_fast_path_buttons(const struct input_behavior_listener_config *config,
+                                   struct input_behavior_listener_data *data) {
+    uint8_t button_set = data->mouse.button_set;
+    uint8_t button_clear = data->mouse.button_clear;
+
+    data->mouse.button_set = data->mouse.button_clear = 0;
+    if (has_rel_data(&data->mouse.data) || has_rel_data(&data->mouse.wheel_data)) {
+        submit_current_frame(config, data);
+    }
+    send_buttons(data->output, button_set, button_clear);
+    data->mouse.fast_path_sent = true;
+}
+
+static void input_behavior_process(const struct input_behavior_listener_config *config,
+                                   struct input_behavior_listener_data *data,
+                                   struct input_event *evt) {
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_RECORDER)
+    record_event(config, evt, IBL_RECORD_RAW);
+#endif
+
+    // First, filter to update the event data as needed.
+    if (!intercept_with_input_config(config, data, evt)) {
+        return;
+    }
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_RECORDER)
+    record_event(config, evt, IBL_RECORD_INTERCEPTED);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS)
+    data->stats.intercepted++;
+#endif
+
+    switch (evt->type) {
+    case INPUT_EV_REL:
+        handle_rel_code(config, data, evt);
+        break;
+    case INPUT_EV_ABS:
+        handle_abs_code(config, data, evt);
+        break;
+    case INPUT_EV_KEY:
+        handle_key_code(config, data, evt);
+        if (config->button_fast_path && (data->mouse.button_set || data->mouse.button_clear)) {
+            send_fast_path_buttons(config, data);
+        }
+        break;
+    }
+
+    if (evt->sync) {
+        if (data->mouse.data.mode == INPUT_LISTENER_XY_DATA_MODE_ABS) {
+            abs_to_rel(config, data);
+        }
+        submit_current_frame(config, data);
+    }
+}
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PROFILING)
+
+static void profile_event(const struct input_behavior_listener_config *config,
+                          struct input_behavior_listener_data *data,
+                          uint32_t start, uint32_t end, bool sync) {
+    struct input_behavior_listener_profile *prof = &data->profile;
+    uint32_t cycles = end - start;
+
+    if (!prof->frame_open) {
+        prof->frame_open = true;
+        prof->frame_start = start;
+    }
+    prof->events++;
+    prof->event_cycles += cycles;
+    prof->event_cycles_max = MAX(prof->event_cycles_max, cycles);
+
+    if (sync) {
+        // frame latency spans from the first event of the frame to the end of sync handling
+        uint32_t frame_cycles = end - prof->frame_start;
+        prof->frame_open = false;
+        prof->frames++;
+        prof->frame_cycles += frame_cycles;
+        prof->frame_cycles_max = MAX(prof->frame_cycles_max, frame_cycles);
+    }
+
+    int64_t now = k_uptime_get();
+    int64_t elapsed = now - prof->window_start;
+    if (elapsed < CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PROFILING_INTERVAL_MS) {
+        return;
+    }
+
+    if (prof->events) {
+        LOG_INF("%s: %u evt/s, %u cyc/evt (max %u), %u us/frame (max %u) over %u frames, "
+                "%u clipped and %u suppressed reports",
+                config->name, (uint32_t)(prof->events * 1000LL / elapsed),
+                (uint32_t)(prof->event_cycles / prof->events), prof->event_cycles_max,
+                prof->frames ? k_cyc_to_us_floor32(prof->frame_cycles / prof->frames) : 0,
+                k_cyc_to_us_floor32(prof->frame_cycles_max), prof->frames,
+                data->output->clipped, data->output->suppressed);
+    }
+
+    bool frame_open = prof->frame_open;
+    uint32_t frame_start = prof->frame_start;
+    *prof = (struct input_behavior_listener_profile){
+        .window_start = now, .frame_open = frame_open, .frame_start = frame_start,
+    };
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PROFILING)
+
+static void input_behavior_handler(const struct input_behavior_listener_config *config,
+                                   struct input_behavior_listener_data *data,
+                                   struct input_event *evt) {
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PROFILING) ||                                \
+    IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS)
+    bool sync = evt->sync;
+    uint32_t start = k_cycle_get_32();
+    input_behavior_process(config, data, evt);
+    uint32_t end = k_cycle_get_32();
+    ARG_UNUSED(sync);
+#else
+    input_behavior_process(config, data, evt);
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS)
+    data->stats.events++;
+    data->stats.cycles += end - start;
+    data->stats.cycles_max = MAX(data->stats.cycles_max, end - start);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PROFILING)
+    profile_event(config, data, start, end, sync);
+#endif
+}
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_DEFERRED)
+
+static K_SEM_DEFINE(listener_thread_sem, 0, 1);
+
+static bool ring_push(struct input_behavior_listener_ring *ring, const struct input_event *evt) {
+    atomic_val_t head = atomic_get(&ring->head);
+    atomic_val_t depth = head - atomic_get(&ring->tail);
+    if (depth >= RING_SIZE) {
+        return false;
+    }
+
+    ring->records[head & (RING_SIZE - 1)] = (struct input_behavior_listener_record){
+        .type = evt->type, .sync = evt->sync, .code = evt->code, .value = evt->value,
+    };
+    // publish the record only after it is written
+    atomic_set(&ring->head, head + 1);
+
+    if (depth + 1 > atomic_get(&ring->high_water)) {
+        atomic_set(&ring->high_water, depth + 1);
+    }
+    return true;
+}
+
+static bool ring_pop(struct input_behavior_listener_ring *ring,
+                     struct input_behavior_listener_record *record) {
+    atomic_val_t tail = atomic_get(&ring->tail);
+    if (tail == atomic_get(&ring->head)) {
+        return false;
+    }
+    *record = ring->records[tail & (RING_SIZE - 1)];
+    atomic_set(&ring->tail, tail + 1);
+    return true;
+}
+
+// Runs on the input driver's thread, so it only copies the event out.
+static void input_behavior_callback(const struct input_behavior_listener_config *config,
+                                    struct input_behavior_listener_data *data,
+                                    struct input_event *evt) {
+    if (!data->layer_enabled) {
+        return;
+    }
+
+    while (!ring_push(&data->ring, evt)) {
+        // motion may be dropped, but a lost button release would leave the button stuck
+        if (evt->type != INPUT_EV_KEY || k_is_in_isr()) {
+            atomic_inc(&data->ring.overflows);
+            return;
+        }
+        k_sem_give(&listener_thread_sem);
+        k_sleep(K_TICKS(1));
+    }
+    k_sem_give(&listener_thread_sem);
+}
+
+#else
+
+static void input_behavior_callback(const struct input_behavior_listener_config *config,
+                                    struct input_behavior_listener_data *data,
+                                    struct input_event *evt) {
+    input_behavior_handler(config, data, evt);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_DEFERRED)
+
+#endif // VALID_LISTENER_COUNT > 0
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_SHARED_REPORT)
+
+// all listeners merge their frames into one report, sent at most once per period
+static struct input_behavior_listener_output shared_output = {
+    .period_ms = CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_SHARED_REPORT_PERIOD_MS,
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PREDICT)
+    .predict_max = CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_SHARED_REPORT_PREDICT_MAX,
+#endif
+};
+
+#define IBL_OUTPUT_DEFINE(n)
+#define IBL_OUTPUT_REF(n) &shared_output
+
+#else
+
+#define IBL_OUTPUT_DEFINE(n)                                                                       \
+    static struct input_behavior_listener_output output_##n = {                                    \
+        .period_ms = DT_INST_PROP(n, report_period_ms),                                            \
+        IF_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PREDICT,                                     \
+                   (.predict_max = DT_INST_PROP(n, predict_max), ))                                \
+        IF_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL,                                  \
+                   (.dev = DEVICE_DT_INST_GET(n), ))                                               \
+    };
+#define IBL_OUTPUT_REF(n) &output_##n
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_SHARED_REPORT)
+
+#define IBL_LAYER_BIT(node_id, prop, idx)                                                          \
+    | ((DT_PROP_BY_IDX(node_id, prop, idx) >= 0) ? BIT(DT_PROP_BY_IDX(node_id, prop, idx) & 0x1f) \
+                                                 : 0)
+
+#define IBL_EXTRACT_BINDING(idx, node_id)                                                          \
+    {                                                                                              \
+        .binding = {                                                                               \
+            .behavior_dev = DEVICE_DT_NAME(DT_PHANDLE_BY_IDX(node_id, bindings, idx)),             \
+            .param1 = COND_CODE_0(DT_PHA_HAS_CELL_AT_IDX(node_id, bindings, idx, param1), (0),     \
+                                  (DT_PHA_BY_IDX(node_id, bindings, idx, param1))),                \
+            .param2 = COND_CODE_0(DT_PHA_HAS_CELL_AT_IDX(node_id, bindings, idx, param2), (0),     \
+                                  (DT_PHA_BY_IDX(node_id, bindings, idx, param2))),                \
+        },                                                                                         \
+        .evt_type = DT_PROP_OR(DT_PHANDLE_BY_IDX(node_id, bindings, idx), evt_type, -1),           \
+        .input_code = DT_PROP_OR(DT_PHANDLE_BY_IDX(node_id, bindings, idx), input_code, -1),       \
+    }
+
+#define IBL_BINDINGS_LEN(node_id) DT_PROP_LEN_OR(node_id, bindings, 0)
+
+// a listener without bindings still gets one unused entry, as its profiles point at them
+// and zero length arrays make the compiler warn about every loop over them
+#define IBL_BINDINGS_SIZE(node_id) MAX(IBL_BINDINGS_LEN(node_id), 1)
+
+// bindings of a listener or profile node, with their resolved copies and dispatch masks
+#define IBL_BINDINGS_DEFINE(node_id)                                                               \
+    BUILD_ASSERT(IBL_BINDINGS_LEN(node_id) <= 32,                                                  \
+                 "An input behavior listener supports up to 32 bindings");                         \
+    static const struct input_behavior_listener_binding_config _CONCAT(                            \
+        ibl_binding_configs_, DT_DEP_ORD(node_id))[IBL_BINDINGS_SIZE(node_id)] = {                 \
+        COND_CODE_1(DT_NODE_HAS_PROP(node_id, bindings),                                           \
+                    (LISTIFY(DT_PROP_LEN(node_id, bindings), IBL_EXTRACT_BINDING, (, ), node_id)), \
+                    ())};                                                                          \
+    static struct input_behavior_listener_binding _CONCAT(ibl_bindings_, DT_DEP_ORD(node_id))      \
+        [IBL_BINDINGS_SIZE(node_id)];                                                              \
+    static uint32_t _CONCAT(ibl_dispatch_, DT_DEP_ORD(node_id))[INPUT_LISTENER_SLOT_COUNT];
+
+#define IBL_CHILD_BINDINGS_DEFINE(node_id)                                                         \
+    IF_ENABLED(DT_NODE_HAS_PROP(node_id, bindings), (IBL_BINDINGS_DEFINE(node_id)))
+
+// A child profile falls back to the value of its listener for properties it does not
+// set, except the booleans, and to the bindings of its listener when it has none.
+#define IBL_PROFILE_ROTATE_DEG(node_id, n)                                                         \
+    DT_PROP_OR(node_id, rotate_deg, DT_INST_PROP(n, rotate_deg))
+
+#define IBL_PROFILE(node_id, n)                                                                    \
+    IBL_PROFILE_WITH_BINDINGS(                                                                     \
+        node_id, n,                                                                                \
+        COND_CODE_1(DT_NODE_HAS_PROP(node_id, bindings), (node_id), (DT_DRV_INST(n))))
+
+#define IBL_PROFILE_WITH_BINDINGS(node_id, n, bindings_node)                                       \
+    {                                                                                              \
+        .evt_type = DT_PROP_OR(node_id, evt_type, DT_INST_PROP(n, evt_type)),                      \
+        .x_input_code = DT_PROP_OR(node_id, x_input_code, DT_INST_PROP(n, x_input_code)),          \
+        .y_input_code = DT_PROP_OR(node_id, y_input_code, DT_INST_PROP(n, y_input_code)),          \
+        .xy_swap = DT_PROP(node_id, xy_swap),                                                      \
+        .x_invert = DT_PROP(node_id, x_invert),                                                    \
+        .y_invert = DT_PROP(node_id, y_invert),                                                    \
+        .scale_multiplier =                                                                        \
+            DT_PROP_OR(node_id, scale_multiplier, DT_INST_PROP(n, scale_multiplier)),              \
+        .scale_divisor = DT_PROP_OR(node_id, scale_divisor, DT_INST_PROP(n, scale_divisor)),       \
+        .scroll_counts_per_detent = DT_PROP_OR(node_id, scroll_counts_per_detent,                  \
+                                               DT_INST_PROP(n, scroll_counts_per_detent)),         \
+        .rotate_deg = IBL_PROFILE_ROTATE_DEG(node_id, n),                                          \
+        .rotate_sin_q15 = IBL_SIN_Q15(IBL_PROFILE_ROTATE_DEG(node_id, n)),                         \
+        .rotate_cos_q15 = IBL_COS_Q15(IBL_PROFILE_ROTATE_DEG(node_id, n)),                         \
+        .rotate_sin = sinf((IBL_PROFILE_ROTATE_DEG(node_id, n) * M_PI / 180.0f)),                  \
+        .rotate_cos = cosf((IBL_PROFILE_ROTATE_DEG(node_id, n) * M_PI / 180.0f)),                  \
+        .layers_mask = 0 DT_FOREACH_PROP_ELEM(node_id, layers, IBL_LAYER_BIT),                     \
+        .bindings_count = IBL_BINDINGS_LEN(bindings_node),                                         \
+        .bindings = _CONCAT(ibl_binding_configs_, DT_DEP_ORD(bindings_node)),                      \
+        .refs = _CONCAT(ibl_bindings_, DT_DEP_ORD(bindings_node)),                                 \
+        .dispatch = _CONCAT(ibl_dispatch_, DT_DEP_ORD(bindings_node)),                             \
+    },
+
+#define IBL_INST(n)                                                                                \
+    COND_CODE_1(                                                                                   \
+        DT_NODE_HAS_STATUS(DT_INST_PHANDLE(n, device), okay),                                      \
+        (IBL_BINDINGS_DEFINE(DT_DRV_INST(n))                                                       \
+        DT_INST_FOREACH_CHILD(n, IBL_CHILD_BINDINGS_DEFINE)                                        \
+        static const struct input_behavior_listener_layer_profile profiles_##n[] = {               \
+            IBL_PROFILE(DT_DRV_INST(n), n)                                                         \
+            DT_INST_FOREACH_CHILD_VARGS(n, IBL_PROFILE, n)};                                       \
+        static const struct input_behavior_listener_config config_##n = {                          \
+            .name = DT_NODE_FULL_NAME(DT_DRV_INST(n)),                                             \
+            .dev = DEVICE_DT_GET(DT_INST_PHANDLE(n, device)),                                      \
+            .rotate_fixed_point = DT_INST_PROP(n, rotate_fixed_point),                             \
+            .abs_rate_control = DT_INST_PROP(n, abs_rate_control),                                 \
+            .abs_deadzone = DT_INST_PROP(n, abs_deadzone),                                         \
+            .abs_rate_period_ms = DT_INST_PROP(n, abs_rate_period_ms),                             \
+            .abs_center_x = DT_INST_PROP(n, abs_center_x),                                         \
+            .abs_center_y = DT_INST_PROP(n, abs_center_y),                                         \
+            .button_fast_path = DT_INST_PROP(n, button_fast_path),                                 \
+            .profiles_count = ARRAY_SIZE(profiles_##n),                                            \
+            .profiles = profiles_##n,                                                              \
+        };                                                                                         \
+        IBL_OUTPUT_DEFINE(n)                                                                       \
+        static struct input_behavior_listener_data data_##n = {                                    \
+            .config = &config_##n,                                                                 \
+            .layer_profile = &profiles_##n[0],                                                     \
+            .output = IBL_OUTPUT_REF(n),                                                           \
+        };                                                                                         \
+        void input_behavior_handler_##n(struct input_event *evt) {                                 \
+            input_behavior_callback(&config_##n, &data_##n, evt);                                  \
+        }                                                                                          \
+        INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(DT_INST_PHANDLE(n, device)),                           \
+                             input_behavior_handler_##n);                                          \
+        IF_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL,                                  \
+                   (DEVICE_DT_INST_DEFINE(n, NULL, NULL, NULL, NULL, POST_KERNEL,                  \
+                                          CONFIG_INPUT_INIT_PRIORITY, NULL);))),                   \
+        ())
+
+DT_INST_FOREACH_STATUS_OKAY(IBL_INST)
+
+#if VALID_LISTENER_COUNT > 0
+
+struct input_behavior_listener_inst {
+    const struct input_behavior_listener_config *config;
+    struct input_behavior_listener_data *data;
+};
+
+#define IBL_INST_REF(n)                                                                            \
+    COND_CODE_1(DT_NODE_HAS_STATUS(DT_INST_PHANDLE(n, device), okay),                              \
+                ({.config = &config_##n, .data = &data_##n},), ())
+
+static const struct input_behavior_listener_inst listeners[] = {
+    DT_INST_FOREACH_STATUS_OKAY(IBL_INST_REF)};
+
+#if !IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+
+// Child profiles take precedence over the listener node, which comes last.
+static void select_profile(const struct input_behavior_listener_config *config,
+                           struct input_behavior_listener_data *data) {
+    for (uint8_t p = 1; p <= config->profiles_count; p++) {
+        const struct input_behavior_listener_layer_profile *prof =
+            &config->profiles[p % config->profiles_count];
+        if (prof->layers_mask & BIT(active_layer)) {
+            data->layer_profile = prof;
+            data->layer_enabled = true;
+            return;
+        }
+    }
+    data->layer_enabled = false;
+}
+
+static void update_layer_state(void) {
+    active_layer = zmk_keymap_highest_layer_active();
+    for (size_t i = 0; i < ARRAY_SIZE(listeners); i++) {
+        select_profile(listeners[i].config, listeners[i].data);
+    }
+}
+
+static int input_behavior_listener_layer_state_changed(const zmk_event_t *eh) {
+    update_layer_state();
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(input_behavior_listener, input_behavior_listener_layer_state_changed);
+ZMK_SUBSCRIPTION(input_behavior_listener, zmk_layer_state_changed);
+
+static void init_profile(const struct input_behavior_listener_layer_profile *prof) {
+    for (uint8_t b = 0; b < prof->bindings_count; b++) {
+        prof->refs[b].binding = prof->bindings[b].binding;
+        if (!resolve_binding(&prof->refs[b])) {
+            LOG_WRN("Behavior %s is not ready", prof->bindings[b].binding.behavior_dev);
+        }
+        for (int slot = 0; slot < INPUT_LISTENER_SLOT_COUNT; slot++) {
+            if (dispatch_slot_accepts(slot, &prof->bindings[b])) {
+                prof->dispatch[slot] |= BIT(b);
+            }
+        }
+    }
+}
+
+#endif // !IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+
+static void init_output(struct input_behavior_listener_output *output) {
+    k_mutex_init(&output->lock);
+    k_work_init_delayable(&output->flush_work, flush_output_work_cb);
+}
+
+static int input_behavior_listener_init(void) {
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_SHARED_REPORT)
+    init_output(&shared_output);
+#endif
+    for (size_t i = 0; i < ARRAY_SIZE(listeners); i++) {
+        const struct input_behavior_listener_config *config = listeners[i].config;
+        struct input_behavior_listener_data *data = listeners[i].data;
+#if !IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_SHARED_REPORT)
+        init_output(data->output);
+#endif
+        k_work_init_delayable(&data->abs.rate_work, abs_rate_work_cb);
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+        // the keymap lives on the central, which runs the layers and bindings
+        data->layer_enabled = true;
+        if (config->profiles_count > 1 || config->profiles[0].bindings_count > 0) {
+            LOG_WRN("%s: profiles and bindings are not run on a split peripheral", config->name);
+        }
+        if (config->profiles[0].scroll_counts_per_detent) {
+            LOG_WRN("%s: scroll-counts-per-detent is applied by the listener of the central",
+                    config->name);
+        }
+#else
+        for (uint8_t p = 0; p < config->profiles_count; p++) {
+            init_profile(&config->profiles[p]);
+        }
+#endif
+    }
+#if !IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+    update_layer_state();
+#endif
+    return 0;
+}
+
+SYS_INIT(input_behavior_listener_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#if IS_ENABLED(CONFIG_SHELL) &&                                                                  \
+    (IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS) ||                                       \
+     IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_RECORDER))
+
+// print to the shell, or to the log when no shell is given
+#define IBL_PRINT(sh, fmt, ...)                                                                    \
+    do {                                                                                           \
+        if (sh) {                                                                                  \
+            shell_print(sh, fmt, ##__VA_ARGS__);                                                   \
+        } else {                                                                                   \
+            LOG_INF(fmt, ##__VA_ARGS__);                                                           \
+        }                                                                                          \
+    } while (0)
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS)
+
+static inline uint32_t avg_cycles(uint64_t cycles, uint32_t count) {
+    return count ? (uint32_t)(cycles / count) : 0;
+}
+
+static void print_stats(const struct shell *sh) {
+    for (size_t i = 0; i < ARRAY_SIZE(listeners); i++) {
+        const struct input_behavior_listener_config *config = listeners[i].config;
+        struct input_behavior_listener_data *data = listeners[i].data;
+        const struct input_behavior_listener_stats *stats = &data->stats;
+
+        IBL_PRINT(sh, "%s: events %u, intercepted %u, opaque %u, errors %u, "
+                  "cycles/event avg %u max %u",
+                  config->name, stats->events, stats->intercepted, stats->opaque, stats->errors,
+                  avg_cycles(stats->cycles, stats->events), stats->cycles_max);
+        IBL_PRINT(sh, "%s: frames %u, motion %u, scroll %u", config->name, stats->frames,
+                  stats->motion, stats->scroll);
+#if !IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_SHARED_REPORT)
+        IBL_PRINT(sh, "%s: reports %u, suppressed %u, clipped %u", config->name,
+                  data->output->reports, data->output->suppressed, data->output->clipped);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_PERIPHERAL)
+        IBL_PRINT(sh, "%s: forwarded events dropped %u", config->name, data->output->dropped);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_DEFERRED)
+        IBL_PRINT(sh, "%s: ring overflows %u, high water %u of %u", config->name,
+                  (uint32_t)atomic_get(&data->ring.overflows),
+                  (uint32_t)atomic_get(&data->ring.high_water), RING_SIZE);
+#endif
+
+        for (uint8_t p = 0; p < config->profiles_count; p++) {
+            const struct input_behavior_listener_layer_profile *prof = &config->profiles[p];
+            // child profiles without own bindings share those of the listener
+            if (p > 0 && prof->refs == config->profiles[0].refs) {
+                continue;
+            }
+            for (uint8_t b = 0; b < prof->bindings_count; b++) {
+                const struct input_behavior_listener_binding_stats *bstats = &prof->refs[b].stats;
+                IBL_PRINT(sh, "%s: profile %u binding %u %s: calls %u, opaque %u, errors %u, "
+                          "cycles/call avg %u max %u",
+                          config->name, p, b, prof->refs[b].binding.behavior_dev, bstats->calls,
+                          bstats->opaque, bstats->errors,
+                          avg_cycles(bstats->cycles, bstats->calls), bstats->cycles_max);
+            }
+        }
+    }
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_SHARED_REPORT)
+    IBL_PRINT(sh, "shared report: reports %u, suppressed %u, clipped %u", shared_output.reports,
+              shared_output.suppressed, shared_output.clipped);
+#endif
+}
+
+static void reset_output_stats(struct input_behavior_listener_output *output) {
+    output->reports = output->suppressed = output->clipped = 0;
+}
+
+static void reset_stats(void) {
+    for (size_t i = 0; i < ARRAY_SIZE(listeners); i++) {
+        struct input_behavior_listener_data *data = listeners[i].data;
+        data->stats = (struct input_behavior_listener_stats){};
+        reset_output_stats(data->output);
+        for (uint8_t p = 0; p < listeners[i].config->profiles_count; p++) {
+            const struct input_behavior_listener_layer_profile *prof =
+                &listeners[i].config->profiles[p];
+            for (uint8_t b = 0; b < prof->bindings_count; b++) {
+                prof->refs[b].stats = (struct input_behavior_listener_binding_stats){};
+            }
+        }
+    }
+}
+
+static int cmd_stats(const struct shell *sh, size_t argc, char **argv) {
+    print_stats(sh);
+    return 0;
+}
+
+static int cmd_stats_log(const struct shell *sh, size_t argc, char **argv) {
+    print_stats(NULL);
+    return 0;
+}
+
+static int cmd_stats_reset(const struct shell *sh, size_t argc, char **argv) {
+    reset_stats();
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_input_listener_stats,
+                               SHELL_CMD(log, NULL, "Write listener stats to the log",
+                                         cmd_stats_log),
+                               SHELL_CMD(reset, NULL, "Reset listener stats", cmd_stats_reset),
+                               SHELL_SUBCMD_SET_END);
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS)
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_RECORDER)
+
+static int listener_index(const struct input_behavior_listener_config *config) {
+    for (size_t i = 0; i < ARRAY_SIZE(listeners); i++) {
+        if (listeners[i].config == config) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static bool first_listener_of_device(int idx) {
+    for (int i = 0; i < idx; i++) {
+        if (listeners[i].config->dev == listeners[idx].config->dev) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Copy the recorded events out of the ring, oldest first, so they can be dumped or
+// replayed without holding the lock. Returns the number of records copied.
+static uint32_t take_records(uint32_t from, struct input_behavior_listener_capture *record) {
+    k_spinlock_key_t key = k_spin_lock(&recorder.lock);
+    uint32_t first = recorder.count > RECORDER_SIZE ? recorder.count - RECORDER_SIZE : 0;
+    uint32_t idx = MAX(from, first);
+    bool found = idx < recorder.count;
+    if (found) {
+        *record = recorder.records[idx % RECORDER_SIZE];
+    }
+    k_spin_unlock(&recorder.lock, key);
+    return found ? idx + 1 : 0;
+}
+
+static void dump_records(const struct shell *sh) {
+    struct input_behavior_listener_capture record;
+    uint32_t start_ticks = 0;
+    bool first = true;
+
+    IBL_PRINT(sh, "time_us,listener,stage,type,code,value,sync");
+    for (uint32_t next = take_records(0, &record); next; next = take_records(next, &record)) {
+        if (first) {
+            start_ticks = record.ticks;
+            first = false;
+        }
+        IBL_PRINT(sh, "%u,%d,%s,%u,%u,%d,%u", k_ticks_to_us_floor32(record.ticks - start_ticks),
+                  listener_index(record.config),
+                  record.stage == IBL_RECORD_RAW ? "raw" : "intercepted", record.type,
+                  record.code, record.value, record.sync);
+    }
+}
+
+static int cmd_record_start(const struct shell *sh, size_t argc, char **argv) {
+    atomic_set(&recorder.enabled, 1);
+    return 0;
+}
+
+static int cmd_record_stop(const struct shell *sh, size_t argc, char **argv) {
+    atomic_set(&recorder.enabled, 0);
+    return 0;
+}
+
+static int cmd_record_clear(const struct shell *sh, size_t argc, char **argv) {
+    k_spinlock_key_t key = k_spin_lock(&recorder.lock);
+    recorder.count = 0;
+    k_spin_unlock(&recorder.lock, key);
+    return 0;
+}
+
+static int cmd_record_dump(const struct shell *sh, size_t argc, char **argv) {
+    dump_records(sh);
+    return 0;
+}
+
+static int cmd_record_dump_log(const struct shell *sh, size_t argc, char **argv) {
+    dump_records(NULL);
+    return 0;
+}
+
+// Feed the raw recorded events back into their listener, or into the listener given
+// by index, keeping the original spacing between events. Recording is paused while
+// replaying, so the capture stays intact and can be replayed again.
+static int cmd_record_replay(const struct shell *sh, size_t argc, char **argv) {
+    int target = -1;
+    if (argc > 1) {
+        target = atoi(argv[1]);
+        if (target < 0 || target >= (int)ARRAY_SIZE(listeners)) {
+            shell_error(sh, "listener index must be below %d", (int)ARRAY_SIZE(listeners));
+            return -EINVAL;
+        }
+    }
+
+    atomic_val_t was_enabled = atomic_set(&recorder.enabled, 0);
+
+    struct input_behavior_listener_capture record;
+    uint32_t last_ticks = 0;
+    uint32_t max_pause = k_ms_to_ticks_ceil32(1000);
+    bool first = true;
+    uint32_t replayed = 0;
+    uint32_t failed = 0;
+    for (uint32_t next = take_records(0, &record); next; next = take_records(next, &record)) {
+        if (record.stage != IBL_RECORD_RAW) {
+            continue;
+        }
+        // every listener of a device gets the replayed events, so replay the capture of
+        // the selected listener only, or of the first listener of each device
+        int idx = listener_index(record.config);
+        if (idx < 0 || (target >= 0 ? idx != target : !first_listener_of_device(idx))) {
+            continue;
+        }
+
+        if (!first) {
+            // cap long pauses of the capture at a second
+            k_sleep(K_TICKS(MIN(record.ticks - last_ticks, max_pause)));
+        }
+        last_ticks = record.ticks;
+        first = false;
+
+        // report through the input subsystem like the sensor driver does, so the
+        // callbacks, and the deferred ring behind them, keep their only producer
+        int ret = input_report(listeners[idx].config->dev, record.type, record.code,
+                               record.value, record.sync, K_FOREVER);
+        if (ret < 0) {
+            failed++;
+        } else {
+            replayed++;
+        }
+    }
+
+    atomic_set(&recorder.enabled, was_enabled);
+    if (failed) {
+        shell_warn(sh, "replayed %u events, %u failed", replayed, failed);
+    } else {
+        shell_print(sh, "replayed %u events", replayed);
+    }
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_input_listener_record_dump,
+                               SHELL_CMD(log, NULL, "Write the capture to the log",
+                                         cmd_record_dump_log),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+    sub_input_listener_record, SHELL_CMD(start, NULL, "Start recording", cmd_record_start),
+    SHELL_CMD(stop, NULL, "Stop recording", cmd_record_stop),
+    SHELL_CMD(clear, NULL, "Clear the capture", cmd_record_clear),
+    SHELL_CMD(dump, &sub_input_listener_record_dump, "Print the capture as CSV", cmd_record_dump),
+    SHELL_CMD_ARG(replay, NULL, "Replay the capture [of listener index]", cmd_record_replay, 1, 1),
+    SHELL_SUBCMD_SET_END);
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_RECORDER)
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+    sub_input_listener,
+    IF_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_STATS,
+               (SHELL_CMD(stats, &sub_input_listener_stats, "Show listener stats", cmd_stats), ))
+        IF_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_RECORDER,
+                   (SHELL_CMD(record, &sub_input_listener_record, "Record and replay input events",
+                              NULL), )) SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(input_listener, &sub_input_listener, "Input behavior listener commands", NULL);
+
+#endif // IS_ENABLED(CONFIG_SHELL) && (STATS || RECORDER)
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_DEFERRED)
+
+static void drain_ring(const struct input_behavior_listener_config *config,
+                       struct input_behavior_listener_data *data) {
+    struct input_behavior_listener_record record;
+    while (ring_pop(&data->ring, &record)) {
+        struct input_event evt = {
+            .dev = config->dev,
+            .sync = record.sync,
+            .type = record.type,
+            .code = record.code,
+            .value = record.value,
+        };
+        input_behavior_handler(config, data, &evt);
+    }
+
+    uint32_t overflows = atomic_get(&data->ring.overflows);
+    if (overflows != data->ring.overflows_reported) {
+        LOG_WRN("%s: %u input events dropped on full ring, high water %u of %u",
+                config->dev->name, overflows - data->ring.overflows_reported,
+                (uint32_t)atomic_get(&data->ring.high_water), RING_SIZE);
+        data->ring.overflows_reported = overflows;
+    }
+}
+
+static void input_behavior_listener_thread(void *p1, void *p2, void *p3) {
+    while (true) {
+        k_sem_take(&listener_thread_sem, K_FOREVER);
+        for (size_t i = 0; i < ARRAY_SIZE(listeners); i++) {
+            drain_ring(listeners[i].config, listeners[i].data);
+        }
+    }
+}
+
+K_THREAD_DEFINE(input_behavior_listener_tid,
+                CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_DEFERRED_THREAD_STACK_SIZE,
+                input_behavior_listener_thread, NULL, NULL, NULL,
+                CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_DEFERRED_THREAD_PRIORITY, 0, 0);
+
+#endif // IS_ENABLED(CONFIG_ZMK_INPUT_BEHAVIOR_LISTENER_DEFERRED)
+
+#endif // VALID_LISTENER_COUNT > 0
 
 // #endif /* DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT) */
@@ -31,9 +31,22 @@ enum scaler_xy_data_mode {
     IB_SCALER_XY_DATA_MODE_ABS,
 };
 
+enum scaler_axis {
+    IB_SCALER_AXIS_X,
+    IB_SCALER_AXIS_Y,
+    IB_SCALER_AXIS_WHEEL,
+    IB_SCALER_AXIS_HWHEEL,
+    IB_SCALER_AXIS_MISC,
+    IB_SCALER_AXIS_COUNT,
+};
+
 struct scaler_xy_data {
     enum scaler_xy_data_mode mode;
-    int16_t delta;
+    enum scaler_axis axis;
+    // scaled remainder of each axis in units of 1 / div, so interleaved axes never
+    // leak sub-unit motion into each other
+    int32_t delta[IB_SCALER_AXIS_COUNT];
+    uint32_t timestamp[IB_SCALER_AXIS_COUNT];
 };
 
 struct behavior_scaler_data {
@@ -44,26 +57,45 @@ struct behavior_scaler_data {
 struct behavior_scaler_config {
     int8_t evt_type;
     int8_t input_code;
+    // without an input-code, scale every axis instead of none
+    bool all_axes;
+    uint32_t remainder_ttl_ms;
 };
 
 static void handle_rel_code(const struct behavior_scaler_config *config,
                             struct behavior_scaler_data *data, struct input_event *evt) {
     switch (evt->code) {
     case INPUT_REL_X:
+        data->data.axis = IB_SCALER_AXIS_X;
+        break;
     case INPUT_REL_Y:
+        data->data.axis = IB_SCALER_AXIS_Y;
+        break;
     case INPUT_REL_WHEEL:
+        data->data.axis = IB_SCALER_AXIS_WHEEL;
+        break;
     case INPUT_REL_HWHEEL:
+        data->data.axis = IB_SCALER_AXIS_HWHEEL;
+        break;
     case INPUT_REL_MISC:
-        data->data.mode = IB_SCALER_XY_DATA_MODE_REL;
-        data->data.delta += evt->value;
+        data->data.axis = IB_SCALER_AXIS_MISC;
         break;
     default:
-        break;
+        return;
     }
+    data->data.mode = IB_SCALER_XY_DATA_MODE_REL;
 }
 
 static void handle_abs_code(const struct behavior_scaler_config *config,
                             struct behavior_scaler_data *data, struct input_event *evt) {
+    switch (evt->code) {
+    case INPUT_ABS_X:
+    case INPUT_ABS_Y:
+        data->data.mode = IB_SCALER_XY_DATA_MODE_ABS;
+        break;
+    default:
+        break;
+    }
 }
 
 static int scaler_keymap_binding_pressed(struct zmk_behavior_binding *binding,
@@ -78,7 +110,7 @@ static int scaler_keymap_binding_pressed(struct zmk_behavior_binding *binding,
     if (evt->type != config->evt_type) {
         return ZMK_BEHAVIOR_TRANSPARENT;
     }
-    if (evt->code != config->input_code) {
+    if (config->input_code >= 0 ? evt->code != config->input_code : !config->all_axes) {
         return ZMK_BEHAVIOR_TRANSPARENT;
     }
     if (!evt->value) {
@@ -104,12 +136,21 @@ static int scaler_keymap_binding_pressed(struct zmk_behavior_binding *binding,
             return ZMK_BEHAVIOR_OPAQUE;
         }
         int16_t div = binding->param2;
-        int16_t delta = data->data.delta;
-        int16_t sval = delta * mul / div;
+        enum scaler_axis axis = data->data.axis;
+        uint32_t now = (uint32_t)event.timestamp;
+        if (config->remainder_ttl_ms &&
+            now - data->data.timestamp[axis] > config->remainder_ttl_ms) {
+            // a stale remainder would fire long after motion stopped
+            data->data.delta[axis] = 0;
+        }
+        data->data.timestamp[axis] = now;
+
+        int32_t delta = data->data.delta[axis] + evt->value * mul;
+        int32_t sval = delta / div;
+        data->data.delta[axis] = delta - sval * div;
+        data->data.mode = IB_SCALER_XY_DATA_MODE_NONE;
         // LOG_DBG("* %d / %d > delta: %d => %d", mul, div, delta, sval);
         if (sval) {
-            data->data.mode = IB_SCALER_XY_DATA_MODE_NONE;
-            data->data.delta = 0;
             evt->value = sval;
             // LOG_DBG("* %d / %d > delta: %d => %d", mul, div, delta, sval);
             return ZMK_BEHAVIOR_TRANSPARENT;
@@ -118,6 +159,15 @@ static int scaler_keymap_binding_pressed(struct zmk_behavior_binding *binding,
         }
     }
 
+    if (data->data.mode == IB_SCALER_XY_DATA_MODE_ABS) {
+        // positions have nothing to accumulate, the listener tracks their deltas
+        data->data.mode = IB_SCALER_XY_DATA_MODE_NONE;
+        int16_t mul = binding->param1;
+        int16_t div = binding->param2;
+        evt->value = evt->value * mul / div;
+        return ZMK_BEHAVIOR_TRANSPARENT;
+    }
+
     return ZMK_BEHAVIOR_TRANSPARENT;
 }
 
@@ -136,6 +186,8 @@ static const struct behavior_driver_api behavior_scaler_driver_api = {
     static struct behavior_scaler_config behavior_scaler_config_##n = {                     \
         .evt_type = DT_INST_PROP(n, evt_type),                                              \
         .input_code = DT_INST_PROP(n, input_code),                                          \
+        .all_axes = DT_INST_PROP(n, all_axes),                                              \
+        .remainder_ttl_ms = DT_INST_PROP(n, remainder_ttl_ms),                              \
     };                                                                                      \
     BEHAVIOR_DT_INST_DEFINE(n, input_behavior_to_init, NULL,                                \
                             &behavior_scaler_data_##n,                                      \
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_input_behavior_smoother
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <drivers/behavior.h>
+#include <zephyr/input/input.h>
+#include <zephyr/dt-bindings/input/input-event-codes.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/keymap.h>
+#include <zmk/behavior.h>
+
+// #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
+
+// positions are Q8, 256 is one count
+#define IB_SMOOTHER_POS_SHIFT 8
+
+// filter coefficients are Q16, 65536 is 1.0
+#define IB_SMOOTHER_ALPHA_SHIFT 16
+
+// time constant in microseconds of a 1 mHz cutoff, 1 / (2 * pi * 0.001 Hz)
+#define IB_SMOOTHER_TAU_US_MHZ 159154943U
+
+enum smoother_axis {
+    IB_SMOOTHER_AXIS_X,
+    IB_SMOOTHER_AXIS_Y,
+    IB_SMOOTHER_AXIS_WHEEL,
+    IB_SMOOTHER_AXIS_HWHEEL,
+    IB_SMOOTHER_AXIS_COUNT,
+};
+
+struct smoother_axis_state {
+    int64_t last;
+    // start of the deadzone window and the motion held back in it, at rest only
+    int64_t held_start;
+    int32_t held;
+    // raw position minus filtered position, in Q8
+    int32_t lag;
+    // filtered speed in counts per second, the derivative of the One-Euro filter
+    int32_t speed;
+    // sub-count remainder of the filtered output, in Q8
+    int32_t rem;
+    bool moving;
+};
+
+struct behavior_smoother_data {
+    const struct device *dev;
+    struct smoother_axis_state axes[IB_SMOOTHER_AXIS_COUNT];
+};
+
+struct behavior_smoother_config {
+    int8_t evt_type;
+    int16_t input_code;
+    uint16_t deadzone;
+    uint16_t deadzone_window_ms;
+    uint16_t rest_speed;
+    uint16_t reset_ms;
+    uint32_t min_cutoff_mhz;
+    uint32_t beta;
+    uint32_t d_cutoff_mhz;
+    uint32_t bypass_speed;
+};
+
+static int smoother_axis(uint16_t code) {
+    switch (code) {
+    case INPUT_REL_X:
+        return IB_SMOOTHER_AXIS_X;
+    case INPUT_REL_Y:
+        return IB_SMOOTHER_AXIS_Y;
+    case INPUT_REL_WHEEL:
+        return IB_SMOOTHER_AXIS_WHEEL;
+    case INPUT_REL_HWHEEL:
+        return IB_SMOOTHER_AXIS_HWHEEL;
+    default:
+        return -1;
+    }
+}
+
+// smoothing factor of a first order low-pass at cutoff_mhz over dt_ms, dt / (dt + tau) in Q16
+static int32_t lowpass_alpha(uint32_t dt_ms, uint32_t cutoff_mhz) {
+    uint64_t dt_us = (uint64_t)dt_ms * 1000;
+    uint64_t tau_us = IB_SMOOTHER_TAU_US_MHZ / MAX(cutoff_mhz, 1);
+    return (int32_t)((dt_us << IB_SMOOTHER_ALPHA_SHIFT) / (dt_us + tau_us));
+}
+
+// Hold motion back at rest until it leaves the deadzone within deadzone-window-ms.
+// Returns the motion to filter, all of it held so far once the deadzone is left.
+static int32_t apply_deadzone(const struct behavior_smoother_config *config,
+                              struct smoother_axis_state *st, int64_t now, int32_t value) {
+    if (st->moving || !config->deadzone) {
+        return value;
+    }
+    if (now - st->held_start > config->deadzone_window_ms) {
+        // jitter is what stays inside the deadzone for a whole window, drop it
+        st->held_start = now;
+        st->held = 0;
+    }
+    st->held += value;
+    if (st->held >= -config->deadzone && st->held <= config->deadzone) {
+        return 0;
+    }
+    value = st->held;
+    st->held = 0;
+    st->moving = true;
+    return value;
+}
+
+// One-Euro filter: the cutoff rises with the filtered speed, so slow motion is smoothed
+// and fast motion passes with little lag, and none at all from bypass-speed up.
+static int32_t apply_filter(const struct behavior_smoother_config *config,
+                            struct smoother_axis_state *st, uint32_t dt_ms, int32_t value) {
+    st->lag += value * (1 << IB_SMOOTHER_POS_SHIFT);
+
+    int32_t dx = (int32_t)(((int64_t)st->lag * 1000 / (int32_t)dt_ms) >> IB_SMOOTHER_POS_SHIFT);
+    st->speed += (int32_t)(((int64_t)(dx - st->speed) *
+                            lowpass_alpha(dt_ms, config->d_cutoff_mhz)) >> IB_SMOOTHER_ALPHA_SHIFT);
+    uint32_t speed = st->speed < 0 ? -st->speed : st->speed;
+
+    if (config->deadzone && config->rest_speed && speed < config->rest_speed) {
+        // back to rest, the next motion has to leave the deadzone again
+        st->moving = false;
+    }
+
+    int32_t out;
+    if (config->bypass_speed && speed >= config->bypass_speed) {
+        out = st->lag;
+    } else {
+        uint32_t cutoff_mhz = config->min_cutoff_mhz + config->beta * MIN(speed, UINT16_MAX);
+        out = (int32_t)(((int64_t)st->lag * lowpass_alpha(dt_ms, cutoff_mhz)) >>
+                        IB_SMOOTHER_ALPHA_SHIFT);
+    }
+    st->lag -= out;
+    return out;
+}
+
+static int smoother_keymap_binding_pressed(struct zmk_behavior_binding *binding,
+                                           struct zmk_behavior_binding_event event) {
+
+    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    struct behavior_smoother_data *data = (struct behavior_smoother_data *)dev->data;
+    const struct behavior_smoother_config *config = dev->config;
+
+    struct input_event *evt = (struct input_event *)event.position;
+    if (config->evt_type >= 0 && evt->type != config->evt_type) {
+        return ZMK_BEHAVIOR_TRANSPARENT;
+    }
+    if (evt->type != INPUT_EV_REL) {
+        return ZMK_BEHAVIOR_TRANSPARENT;
+    }
+    if (config->input_code >= 0 && evt->code != config->input_code) {
+        return ZMK_BEHAVIOR_TRANSPARENT;
+    }
+    int axis = smoother_axis(evt->code);
+    if (axis < 0 || !evt->value) {
+        return ZMK_BEHAVIOR_TRANSPARENT;
+    }
+
+    struct smoother_axis_state *st = &data->axes[axis];
+    int64_t now = event.timestamp;
+    int64_t elapsed = now - st->last;
+    st->last = now;
+    // whole counts the filter still lagged behind when the last stroke stopped, which can
+    // be several at low speed
+    int32_t lagged = 0;
+    if (elapsed > config->reset_ms) {
+        // motion resumed after idle, send what the last stroke left behind with this event
+        // and start over at rest, only the fraction of a count is dropped
+        lagged = (st->lag + st->rem) / (1 << IB_SMOOTHER_POS_SHIFT);
+        *st = (struct smoother_axis_state){.last = now, .held_start = now};
+        elapsed = config->reset_ms;
+    }
+    uint32_t dt_ms = (uint32_t)CLAMP(elapsed, 1, config->reset_ms);
+
+    int32_t value = apply_deadzone(config, st, now, CLAMP(evt->value, INT16_MIN, INT16_MAX));
+    if (value) {
+        int32_t out = st->rem + apply_filter(config, st, dt_ms, value);
+        // truncate towards zero, so jitter around rest never rounds into a count
+        int32_t sval = out / (1 << IB_SMOOTHER_POS_SHIFT);
+        st->rem = out - sval * (1 << IB_SMOOTHER_POS_SHIFT);
+        value = sval;
+    }
+    // LOG_DBG("speed %d lag %d > %d => %d", st->speed, st->lag, evt->value, value);
+
+    // a zero value keeps the event, and so its sync, flowing to the listener, which
+    // suppresses the report when the whole frame was filtered out
+    evt->value = value + lagged;
+    return ZMK_BEHAVIOR_TRANSPARENT;
+}
+
+static int input_behavior_smoother_init(const struct device *dev) {
+    struct behavior_smoother_data *data = dev->data;
+    data->dev = dev;
+    return 0;
+};
+
+static const struct behavior_driver_api behavior_smoother_driver_api = {
+    .binding_pressed = smoother_keymap_binding_pressed,
+};
+
+#define IBSMO_INST(n)                                                                       \
+    BUILD_ASSERT(DT_INST_PROP(n, reset_ms) > 0, "reset-ms must be greater than 0");         \
+    static struct behavior_smoother_data behavior_smoother_data_##n = {};                   \
+    static const struct behavior_smoother_config behavior_smoother_config_##n = {           \
+        .evt_type = DT_INST_PROP(n, evt_type),                                              \
+        .input_code = DT_INST_PROP(n, input_code),                                          \
+        .deadzone = DT_INST_PROP(n, deadzone),                                              \
+        .deadzone_window_ms = DT_INST_PROP(n, deadzone_window_ms),                          \
+        .rest_speed = DT_INST_PROP(n, rest_speed),                                          \
+        .reset_ms = DT_INST_PROP(n, reset_ms),                                              \
+        .min_cutoff_mhz = DT_INST_PROP(n, min_cutoff_mhz),                                  \
+        .beta = DT_INST_PROP(n, beta),                                                      \
+        .d_cutoff_mhz = DT_INST_PROP(n, d_cutoff_mhz),                                      \
+        .bypass_speed = DT_INST_PROP(n, bypass_speed),                                      \
+    };                                                                                      \
+    BEHAVIOR_DT_INST_DEFINE(n, input_behavior_smoother_init, NULL,                          \
+                            &behavior_smoother_data_##n,                                    \
+                            &behavior_smoother_config_##n,                                  \
+                            POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,               \
+                            &behavior_smoother_driver_api);
+
+DT_INST_FOREACH_STATUS_OKAY(IBSMO_INST)
+
+// #endif /* DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT) */
@@ -9,6 +9,7 @@
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <drivers/behavior.h>
+#include <zephyr/input/input.h>
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
@@ -19,13 +20,21 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 // #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
 
 struct behavior_tog_layer_config {
+    int8_t evt_type;
+    int16_t input_code;
     uint32_t time_to_live_ms;
+    bool activate_immediately;
 };
 
 struct behavior_tog_layer_data {
     uint8_t toggle_layer;
     struct k_work_delayable toggle_layer_activate_work;
     struct k_work_delayable toggle_layer_deactivate_work;
+    // uptime of the last input event, the deactivate work checks it on expiry
+    // instead of being rescheduled on every event
+    atomic_t last_activity;
+    // set while the deactivate work is scheduled
+    atomic_t deactivate_armed;
     const struct device *dev;
 };
 
@@ -34,6 +43,20 @@ static void toggle_layer_deactivate_cb(struct k_work *work) {
     struct behavior_tog_layer_data *data = CONTAINER_OF(work_delayable, 
                                                         struct behavior_tog_layer_data,
                                                         toggle_layer_deactivate_work);
+    const struct behavior_tog_layer_config *cfg = data->dev->config;
+
+    // disarm before reading the timestamp, so an event arriving meanwhile
+    // either is seen here or arms the work again itself
+    atomic_set(&data->deactivate_armed, 0);
+    uint32_t idle_ms = k_uptime_get_32() - (uint32_t)atomic_get(&data->last_activity);
+    if (idle_ms < cfg->time_to_live_ms) {
+        if (atomic_cas(&data->deactivate_armed, 0, 1)) {
+            k_work_schedule(&data->toggle_layer_deactivate_work,
+                            K_MSEC(cfg->time_to_live_ms - idle_ms));
+        }
+        return;
+    }
+
     if (!zmk_keymap_layer_active(data->toggle_layer)) {
       return;
     }
@@ -55,12 +78,33 @@ static int to_keymap_binding_pressed(struct zmk_behavior_binding *binding,
     const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
     struct behavior_tog_layer_data *data = (struct behavior_tog_layer_data *)dev->data;
     const struct behavior_tog_layer_config *cfg = dev->config;
+
+    struct input_event *evt = (struct input_event *)event.position;
+    if (cfg->evt_type >= 0 && evt->type != cfg->evt_type) {
+        return ZMK_BEHAVIOR_TRANSPARENT;
+    }
+    if (cfg->input_code >= 0 && evt->code != cfg->input_code) {
+        return ZMK_BEHAVIOR_TRANSPARENT;
+    }
+
     data->toggle_layer = binding->param1;
     if (!zmk_keymap_layer_active(data->toggle_layer)) {
-        // LOG_DBG("schedule activate layer %d", data->toggle_layer);
-        k_work_schedule(&data->toggle_layer_activate_work, K_MSEC(0));
+        // the keymap must not be changed from an ISR, defer it there as well
+        if (cfg->activate_immediately && !k_is_in_isr()) {
+            LOG_DBG("activate layer %d", data->toggle_layer);
+            zmk_keymap_layer_activate(data->toggle_layer);
+        } else {
+            // LOG_DBG("schedule activate layer %d", data->toggle_layer);
+            k_work_schedule(&data->toggle_layer_activate_work, K_MSEC(0));
+        }
+    }
+
+    // only record the activity, the deactivate work re-arms itself on expiry
+    // while events keep coming
+    atomic_set(&data->last_activity, k_uptime_get_32());
+    if (atomic_cas(&data->deactivate_armed, 0, 1)) {
+        k_work_schedule(&data->toggle_layer_deactivate_work, K_MSEC(cfg->time_to_live_ms));
     }
-    k_work_schedule(&data->toggle_layer_deactivate_work, K_MSEC(cfg->time_to_live_ms));
     return ZMK_BEHAVIOR_TRANSPARENT;
 }
 
@@ -79,7 +123,10 @@ static const struct behavior_driver_api behavior_tog_layer_driver_api = {
 #define KP_INST(n)                                                                      \
     static struct behavior_tog_layer_data behavior_tog_layer_data_##n = {};             \
     static struct behavior_tog_layer_config behavior_tog_layer_config_##n = {           \
+        .evt_type = DT_INST_PROP(n, evt_type),                                          \
+        .input_code = DT_INST_PROP(n, input_code),                                      \
         .time_to_live_ms = DT_INST_PROP(n, time_to_live_ms),                            \
+        .activate_immediately = DT_INST_PROP(n, activate_immediately),                  \
     };                                                                                  \
     BEHAVIOR_DT_INST_DEFINE(n, input_behavior_to_init, NULL,                            \
                             &behavior_tog_layer_data_##n,                               \
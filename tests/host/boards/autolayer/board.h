@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Devicetree of a trackball listener which raises layer 1 inline with the first event it
+// moves, and whose profile on layer 1 rotates by 90 degrees and halves the motion with a
+// scaler of its own. The macros below are what Zephyr generates from it, written out by
+// hand.
+//
+//     ib_scaler: input_behavior_scaler {
+//         compatible = "zmk,input-behavior-scaler";
+//         evt-type = <INPUT_EV_REL>;
+//         all-axes;
+//         #binding-cells = <2>;
+//     };
+//     intl: input_behavior_tog_layer {
+//         compatible = "zmk,input-behavior-tog-layer";
+//         time-to-live-ms = <300>;
+//         activate-immediately;
+//         #binding-cells = <1>;
+//     };
+//     trackball_listener {
+//         compatible = "zmk,input-behavior-listener";
+//         device = <&trackball>;
+//         layers = <0>;
+//         evt-type = <INPUT_EV_REL>;
+//         x-input-code = <INPUT_REL_X>;
+//         y-input-code = <INPUT_REL_Y>;
+//         rotate-fixed-point;
+//         bindings = <&intl 1>;
+//
+//         mouse {
+//             layers = <1>;
+//             rotate-deg = <90>;
+//             bindings = <&intl 1 &ib_scaler 1 2>;
+//         };
+//     };
+
+#pragma once
+
+#define DT_FOREACH_NODE(fn)                                                                        \
+    fn(DT_N_S_trackball) fn(DT_N_S_behaviors_S_input_behavior_scaler)                              \
+    fn(DT_N_S_behaviors_S_input_behavior_tog_layer) fn(DT_N_S_trackball_listener)                  \
+    fn(DT_N_S_trackball_listener_S_mouse)
+
+// trackball
+#define DT_N_S_trackball_ORD 10
+#define DT_N_S_trackball_FULL_NAME "trackball"
+#define DT_N_S_trackball_STATUS_okay 1
+
+// ib_scaler
+#define DT_N_S_behaviors_S_input_behavior_scaler_ORD 11
+#define DT_N_S_behaviors_S_input_behavior_scaler_FULL_NAME "input_behavior_scaler"
+#define DT_N_S_behaviors_S_input_behavior_scaler_STATUS_okay 1
+#define DT_N_S_behaviors_S_input_behavior_scaler_P_evt_type 2
+#define DT_N_S_behaviors_S_input_behavior_scaler_P_evt_type_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_scaler_P_input_code -1
+#define DT_N_S_behaviors_S_input_behavior_scaler_P_input_code_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_scaler_P_all_axes 1
+#define DT_N_S_behaviors_S_input_behavior_scaler_P_all_axes_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_scaler_P_remainder_ttl_ms 0
+#define DT_N_S_behaviors_S_input_behavior_scaler_P_remainder_ttl_ms_EXISTS 1
+
+// intl
+#define DT_N_S_behaviors_S_input_behavior_tog_layer_ORD 12
+#define DT_N_S_behaviors_S_input_behavior_tog_layer_FULL_NAME "input_behavior_tog_layer"
+#define DT_N_S_behaviors_S_input_behavior_tog_layer_STATUS_okay 1
+#define DT_N_S_behaviors_S_input_behavior_tog_layer_P_time_to_live_ms 300
+#define DT_N_S_behaviors_S_input_behavior_tog_layer_P_time_to_live_ms_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_tog_layer_P_evt_type -1
+#define DT_N_S_behaviors_S_input_behavior_tog_layer_P_evt_type_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_tog_layer_P_input_code -1
+#define DT_N_S_behaviors_S_input_behavior_tog_layer_P_input_code_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_tog_layer_P_activate_immediately 1
+#define DT_N_S_behaviors_S_input_behavior_tog_layer_P_activate_immediately_EXISTS 1
+
+// trackball_listener
+#define DT_N_S_trackball_listener_ORD 13
+#define DT_N_S_trackball_listener_FULL_NAME "trackball_listener"
+#define DT_N_S_trackball_listener_STATUS_okay 1
+#define DT_N_S_trackball_listener_P_device_IDX_0_PH DT_N_S_trackball
+#define DT_N_S_trackball_listener_P_device_EXISTS 1
+#define DT_N_S_trackball_listener_P_xy_swap 0
+#define DT_N_S_trackball_listener_P_xy_swap_EXISTS 1
+#define DT_N_S_trackball_listener_P_x_invert 0
+#define DT_N_S_trackball_listener_P_x_invert_EXISTS 1
+#define DT_N_S_trackball_listener_P_y_invert 0
+#define DT_N_S_trackball_listener_P_y_invert_EXISTS 1
+#define DT_N_S_trackball_listener_P_scale_multiplier 1
+#define DT_N_S_trackball_listener_P_scale_multiplier_EXISTS 1
+#define DT_N_S_trackball_listener_P_scale_divisor 1
+#define DT_N_S_trackball_listener_P_scale_divisor_EXISTS 1
+#define DT_N_S_trackball_listener_P_scroll_counts_per_detent 0
+#define DT_N_S_trackball_listener_P_scroll_counts_per_detent_EXISTS 1
+#define DT_N_S_trackball_listener_P_rotate_deg 0
+#define DT_N_S_trackball_listener_P_rotate_deg_EXISTS 1
+#define DT_N_S_trackball_listener_P_rotate_fixed_point 1
+#define DT_N_S_trackball_listener_P_rotate_fixed_point_EXISTS 1
+#define DT_N_S_trackball_listener_P_report_period_ms 0
+#define DT_N_S_trackball_listener_P_report_period_ms_EXISTS 1
+#define DT_N_S_trackball_listener_P_predict_max 0
+#define DT_N_S_trackball_listener_P_predict_max_EXISTS 1
+#define DT_N_S_trackball_listener_P_button_fast_path 0
+#define DT_N_S_trackball_listener_P_button_fast_path_EXISTS 1
+#define DT_N_S_trackball_listener_P_abs_rate_control 0
+#define DT_N_S_trackball_listener_P_abs_rate_control_EXISTS 1
+#define DT_N_S_trackball_listener_P_abs_deadzone 0
+#define DT_N_S_trackball_listener_P_abs_deadzone_EXISTS 1
+#define DT_N_S_trackball_listener_P_abs_rate_period_ms 10
+#define DT_N_S_trackball_listener_P_abs_rate_period_ms_EXISTS 1
+#define DT_N_S_trackball_listener_P_abs_center_x 0
+#define DT_N_S_trackball_listener_P_abs_center_x_EXISTS 1
+#define DT_N_S_trackball_listener_P_abs_center_y 0
+#define DT_N_S_trackball_listener_P_abs_center_y_EXISTS 1
+#define DT_N_S_trackball_listener_P_evt_type 2
+#define DT_N_S_trackball_listener_P_evt_type_EXISTS 1
+#define DT_N_S_trackball_listener_P_x_input_code 0
+#define DT_N_S_trackball_listener_P_x_input_code_EXISTS 1
+#define DT_N_S_trackball_listener_P_y_input_code 1
+#define DT_N_S_trackball_listener_P_y_input_code_EXISTS 1
+#define DT_N_S_trackball_listener_P_layers_IDX_0 0
+#define DT_N_S_trackball_listener_P_layers_LEN 1
+#define DT_N_S_trackball_listener_P_layers_EXISTS 1
+#define DT_N_S_trackball_listener_P_layers_FOREACH_PROP_ELEM(fn)                                   \
+    fn(DT_N_S_trackball_listener, layers, 0)
+#define DT_N_S_trackball_listener_P_bindings_IDX_0_PH DT_N_S_behaviors_S_input_behavior_tog_layer
+#define DT_N_S_trackball_listener_P_bindings_IDX_0_VAL_param1 1
+#define DT_N_S_trackball_listener_P_bindings_IDX_0_VAL_param1_EXISTS 1
+#define DT_N_S_trackball_listener_P_bindings_LEN 1
+#define DT_N_S_trackball_listener_P_bindings_EXISTS 1
+#define DT_N_S_trackball_listener_FOREACH_CHILD(fn) fn(DT_N_S_trackball_listener_S_mouse)
+#define DT_N_S_trackball_listener_FOREACH_CHILD_VARGS(fn, ...)                                     \
+    fn(DT_N_S_trackball_listener_S_mouse, __VA_ARGS__)
+
+// trackball_listener/mouse
+#define DT_N_S_trackball_listener_S_mouse_ORD 14
+#define DT_N_S_trackball_listener_S_mouse_FULL_NAME "mouse"
+#define DT_N_S_trackball_listener_S_mouse_STATUS_okay 1
+#define DT_N_S_trackball_listener_S_mouse_P_xy_swap 0
+#define DT_N_S_trackball_listener_S_mouse_P_xy_swap_EXISTS 1
+#define DT_N_S_trackball_listener_S_mouse_P_x_invert 0
+#define DT_N_S_trackball_listener_S_mouse_P_x_invert_EXISTS 1
+#define DT_N_S_trackball_listener_S_mouse_P_y_invert 0
+#define DT_N_S_trackball_listener_S_mouse_P_y_invert_EXISTS 1
+#define DT_N_S_trackball_listener_S_mouse_P_rotate_deg 90
+#define DT_N_S_trackball_listener_S_mouse_P_rotate_deg_EXISTS 1
+#define DT_N_S_trackball_listener_S_mouse_P_layers_IDX_0 1
+#define DT_N_S_trackball_listener_S_mouse_P_layers_LEN 1
+#define DT_N_S_trackball_listener_S_mouse_P_layers_EXISTS 1
+#define DT_N_S_trackball_listener_S_mouse_P_layers_FOREACH_PROP_ELEM(fn)                           \
+    fn(DT_N_S_trackball_listener_S_mouse, layers, 0)
+#define DT_N_S_trackball_listener_S_mouse_P_bindings_IDX_0_PH                                      \
+    DT_N_S_behaviors_S_input_behavior_tog_layer
+#define DT_N_S_trackball_listener_S_mouse_P_bindings_IDX_0_VAL_param1 1
+#define DT_N_S_trackball_listener_S_mouse_P_bindings_IDX_0_VAL_param1_EXISTS 1
+#define DT_N_S_trackball_listener_S_mouse_P_bindings_IDX_1_PH                                      \
+    DT_N_S_behaviors_S_input_behavior_scaler
+#define DT_N_S_trackball_listener_S_mouse_P_bindings_IDX_1_VAL_param1 1
+#define DT_N_S_trackball_listener_S_mouse_P_bindings_IDX_1_VAL_param1_EXISTS 1
+#define DT_N_S_trackball_listener_S_mouse_P_bindings_IDX_1_VAL_param2 2
+#define DT_N_S_trackball_listener_S_mouse_P_bindings_IDX_1_VAL_param2_EXISTS 1
+#define DT_N_S_trackball_listener_S_mouse_P_bindings_LEN 2
+#define DT_N_S_trackball_listener_S_mouse_P_bindings_EXISTS 1
+#define DT_N_S_trackball_listener_S_mouse_FOREACH_CHILD(fn)
+#define DT_N_S_trackball_listener_S_mouse_FOREACH_CHILD_VARGS(fn, ...)
+
+// instances of zmk,input-behavior-scaler
+#define DT_N_INST_0_zmk_input_behavior_scaler DT_N_S_behaviors_S_input_behavior_scaler
+#define DT_COMPAT_HAS_OKAY_zmk_input_behavior_scaler 1
+#define DT_FOREACH_OKAY_INST_zmk_input_behavior_scaler(fn) fn(0)
+
+// instances of zmk,input-behavior-tog-layer
+#define DT_N_INST_0_zmk_input_behavior_tog_layer DT_N_S_behaviors_S_input_behavior_tog_layer
+#define DT_COMPAT_HAS_OKAY_zmk_input_behavior_tog_layer 1
+#define DT_FOREACH_OKAY_INST_zmk_input_behavior_tog_layer(fn) fn(0)
+
+// instances of zmk,input-behavior-listener
+#define DT_N_INST_0_zmk_input_behavior_listener DT_N_S_trackball_listener
+#define DT_COMPAT_HAS_OKAY_zmk_input_behavior_listener 1
+#define DT_FOREACH_OKAY_INST_zmk_input_behavior_listener(fn) fn(0)
+
+// the device the harness reports input from
+#define HARNESS_INPUT_NODE DT_N_S_trackball
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Devicetree of a trackball listener which coalesces motion into a report every 8 ms
+// and sends button changes right away, extrapolating motion by up to 12 counts per axis.
+// The macros below are what Zephyr generates from it, written out by hand.
+//
+//     trackball_listener {
+//         compatible = "zmk,input-behavior-listener";
+//         device = <&trackball>;
+//         layers = <0 1 2>;
+//         evt-type = <INPUT_EV_REL>;
+//         report-period-ms = <8>;
+//         button-fast-path;
+//         predict-max = <12>;
+//     };
+
+#pragma once
+
+#define DT_FOREACH_NODE(fn) fn(DT_N_S_trackball) fn(DT_N_S_trackball_listener)
+
+// trackball
+#define DT_N_S_trackball_ORD 10
+#define DT_N_S_trackball_FULL_NAME "trackball"
+#define DT_N_S_trackball_STATUS_okay 1
+
+// trackball_listener
+#define DT_N_S_trackball_listener_ORD 11
+#define DT_N_S_trackball_listener_FULL_NAME "trackball_listener"
+#define DT_N_S_trackball_listener_STATUS_okay 1
+#define DT_N_S_trackball_listener_P_device_IDX_0_PH DT_N_S_trackball
+#define DT_N_S_trackball_listener_P_device_EXISTS 1
+#define DT_N_S_trackball_listener_P_xy_swap 0
+#define DT_N_S_trackball_listener_P_xy_swap_EXISTS 1
+#define DT_N_S_trackball_listener_P_x_invert 0
+#define DT_N_S_trackball_listener_P_x_invert_EXISTS 1
+#define DT_N_S_trackball_listener_P_y_invert 0
+#define DT_N_S_trackball_listener_P_y_invert_EXISTS 1
+#define DT_N_S_trackball_listener_P_scale_multiplier 1
+#define DT_N_S_trackball_listener_P_scale_multiplier_EXISTS 1
+#define DT_N_S_trackball_listener_P_scale_divisor 1
+#define DT_N_S_trackball_listener_P_scale_divisor_EXISTS 1
+#define DT_N_S_trackball_listener_P_scroll_counts_per_detent 0
+#define DT_N_S_trackball_listener_P_scroll_counts_per_detent_EXISTS 1
+#define DT_N_S_trackball_listener_P_rotate_deg 0
+#define DT_N_S_trackball_listener_P_rotate_deg_EXISTS 1
+#define DT_N_S_trackball_listener_P_rotate_fixed_point 0
+#define DT_N_S_trackball_listener_P_rotate_fixed_point_EXISTS 1
+#define DT_N_S_trackball_listener_P_report_period_ms 8
+#define DT_N_S_trackball_listener_P_report_period_ms_EXISTS 1
+#define DT_N_S_trackball_listener_P_predict_max 12
+#define DT_N_S_trackball_listener_P_predict_max_EXISTS 1
+#define DT_N_S_trackball_listener_P_button_fast_path 1
+#define DT_N_S_trackball_listener_P_button_fast_path_EXISTS 1
+#define DT_N_S_trackball_listener_P_abs_rate_control 0
+#define DT_N_S_trackball_listener_P_abs_rate_control_EXISTS 1
+#define DT_N_S_trackball_listener_P_abs_deadzone 0
+#define DT_N_S_trackball_listener_P_abs_deadzone_EXISTS 1
+#define DT_N_S_trackball_listener_P_abs_rate_period_ms 10
+#define DT_N_S_trackball_listener_P_abs_rate_period_ms_EXISTS 1
+#define DT_N_S_trackball_listener_P_abs_center_x 0
+#define DT_N_S_trackball_listener_P_abs_center_x_EXISTS 1
+#define DT_N_S_trackball_listener_P_abs_center_y 0
+#define DT_N_S_trackball_listener_P_abs_center_y_EXISTS 1
+#define DT_N_S_trackball_listener_P_evt_type 2
+#define DT_N_S_trackball_listener_P_evt_type_EXISTS 1
+#define DT_N_S_trackball_listener_P_x_input_code -1
+#define DT_N_S_trackball_listener_P_x_input_code_EXISTS 1
+#define DT_N_S_trackball_listener_P_y_input_code -1
+#define DT_N_S_trackball_listener_P_y_input_code_EXISTS 1
+#define DT_N_S_trackball_listener_P_layers_IDX_0 0
+#define DT_N_S_trackball_listener_P_layers_IDX_1 1
+#define DT_N_S_trackball_listener_P_layers_IDX_2 2
+#define DT_N_S_trackball_listener_P_layers_LEN 3
+#define DT_N_S_trackball_listener_P_layers_EXISTS 1
+#define DT_N_S_trackball_listener_P_layers_FOREACH_PROP_ELEM(fn)                                   \
+    fn(DT_N_S_trackball_listener, layers, 0) fn(DT_N_S_trackball_listener, layers, 1)              \
+    fn(DT_N_S_trackball_listener, layers, 2)
+#define DT_N_S_trackball_listener_FOREACH_CHILD(fn)
+#define DT_N_S_trackball_listener_FOREACH_CHILD_VARGS(fn, ...)
+
+// instances of zmk,input-behavior-listener
+#define DT_N_INST_0_zmk_input_behavior_listener DT_N_S_trackball_listener
+#define DT_COMPAT_HAS_OKAY_zmk_input_behavior_listener 1
+#define DT_FOREACH_OKAY_INST_zmk_input_behavior_listener(fn) fn(0)
+
+// the device the harness reports input from
+#define HARNESS_INPUT_NODE DT_N_S_trackball
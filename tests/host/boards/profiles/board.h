@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Devicetree of a trackball listener with layer profiles: tilted by a negative angle in
+// float on the base layer, straight on layer 1 and scrolling on layer 2, smoothed and
+// accelerated on all of them. The macros below are what Zephyr generates from it,
+// written out by hand.
+//
+//     ib_smoother: input_behavior_smoother {
+//         compatible = "zmk,input-behavior-smoother";
+//         evt-type = <INPUT_EV_REL>;
+//         deadzone = <2>;
+//         #binding-cells = <0>;
+//     };
+//     ib_accel: input_behavior_accel {
+//         compatible = "zmk,input-behavior-accel";
+//         evt-type = <INPUT_EV_REL>;
+//         speed-min = <100>;
+//         speed-max = <3000>;
+//         gain-min = <50>;
+//         #binding-cells = <0>;
+//     };
+//     trackball_listener {
+//         compatible = "zmk,input-behavior-listener";
+//         device = <&trackball>;
+//         layers = <1>;
+//         evt-type = <INPUT_EV_REL>;
+//         x-input-code = <INPUT_REL_X>;
+//         y-input-code = <INPUT_REL_Y>;
+//         bindings = <&ib_smoother &ib_accel>;
+//
+//         tilt {
+//             layers = <0>;
+//             rotate-deg = <(-30)>;
+//         };
+//
+//         scroll {
+//             layers = <2>;
+//             x-input-code = <INPUT_REL_HWHEEL>;
+//             y-input-code = <INPUT_REL_WHEEL>;
+//             y-invert;
+//             scroll-counts-per-detent = <4>;
+//         };
+//     };
+
+#pragma once
+
+#define DT_FOREACH_NODE(fn)                                                                        \
+    fn(DT_N_S_trackball) fn(DT_N_S_behaviors_S_input_behavior_smoother)                            \
+    fn(DT_N_S_behaviors_S_input_behavior_accel) fn(DT_N_S_trackball_listener)                      \
+    fn(DT_N_S_trackball_listener_S_tilt) fn(DT_N_S_trackball_listener_S_scroll)
+
+// trackball
+#define DT_N_S_trackball_ORD 10
+#define DT_N_S_trackball_FULL_NAME "trackball"
+#define DT_N_S_trackball_STATUS_okay 1
+
+// ib_smoother
+#define DT_N_S_behaviors_S_input_behavior_smoother_ORD 11
+#define DT_N_S_behaviors_S_input_behavior_smoother_FULL_NAME "input_behavior_smoother"
+#define DT_N_S_behaviors_S_input_behavior_smoother_STATUS_okay 1
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_evt_type 2
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_evt_type_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_input_code -1
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_input_code_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_deadzone 2
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_deadzone_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_deadzone_window_ms 100
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_deadzone_window_ms_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_rest_speed 50
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_rest_speed_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_reset_ms 250
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_reset_ms_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_min_cutoff_mhz 10000
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_min_cutoff_mhz_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_beta 50
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_beta_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_d_cutoff_mhz 10000
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_d_cutoff_mhz_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_bypass_speed 1500
+#define DT_N_S_behaviors_S_input_behavior_smoother_P_bypass_speed_EXISTS 1
+
+// ib_accel
+#define DT_N_S_behaviors_S_input_behavior_accel_ORD 12
+#define DT_N_S_behaviors_S_input_behavior_accel_FULL_NAME "input_behavior_accel"
+#define DT_N_S_behaviors_S_input_behavior_accel_STATUS_okay 1
+#define DT_N_S_behaviors_S_input_behavior_accel_P_evt_type 2
+#define DT_N_S_behaviors_S_input_behavior_accel_P_evt_type_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_accel_P_input_code -1
+#define DT_N_S_behaviors_S_input_behavior_accel_P_input_code_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_accel_P_speed_min 100
+#define DT_N_S_behaviors_S_input_behavior_accel_P_speed_min_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_accel_P_speed_max 3000
+#define DT_N_S_behaviors_S_input_behavior_accel_P_speed_max_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_accel_P_gain_min 50
+#define DT_N_S_behaviors_S_input_behavior_accel_P_gain_min_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_accel_P_gain_max 300
+#define DT_N_S_behaviors_S_input_behavior_accel_P_gain_max_EXISTS 1
+#define DT_N_S_behaviors_S_input_behavior_accel_P_curve_exponent 2
+#define DT_N_S_behaviors_S_input_behavior_accel_P_curve_exponent_EXISTS 1
+
+// trackball_listener
+#define DT_N_S_trackball_listener_ORD 13
+#define DT_N_S_trackball_listener_FULL_NAME "trackball_listener"
+#define DT_N_S_trackball_listener_STATUS_okay 1
+#define DT_N_S_trackball_listener_P_device_IDX_0_PH DT_N_S_trackball
+#define DT_N_S_trackball_listener_P_device_EXISTS 1
+#define DT_N_S_trackball_listener_P_xy_swap 0
+#define DT_N_S_trackball_listener_P_xy_swap_EXISTS 1
+#define DT_N_S_trackball_listener_P_x_invert 0
+#define DT_N_S_trackball_listener_P_x_invert_EXISTS 1
+#define DT_N_S_trackball_listener_P_y_invert 0
+#define DT_N_S_trackball_listener_P_y_invert_EXISTS 1
+#define DT_N_S_trackball_listener_P_scale_multiplier 1
+#define DT_N_S_trackball_listener_P_scale_multiplier_EXISTS 1
+#define DT_N_S_trackball_listener_P_scale_divisor 1
+#define DT_N_S_trackball_listener_P_scale_divisor_EXISTS 1
+#define DT_N_S_trackball_listener_P_scroll_counts_per_detent 0
+#define DT_N_S_trackball_listener_P_scroll_counts_per_detent_EXISTS 1
+#define DT_N_S_trackball_listener_P_rotate_deg 0
+#define DT_N_S_trackball_listener_P_rotate_deg_EXISTS 1
+#define DT_N_S_trackball_listener_P_rotate_fixed_point 0
+#define DT_N_S_trackball_listener_P_rotate_fixed_point_EXISTS 1
+#define DT_N_S_trackball_listener_P_report_period_ms 0
+#define DT_N_S_trackball_listener_P_report_period_ms_EXISTS 1
+#define DT_N_S_trackball_listener_P_predict_max 0
+#define DT_N_S_trackball_listener_P_predict_max_EXISTS 1
+#define DT_N_S_trackball_listener_P_button_fast_path 0
+#define DT_N_S_trackball_listener_P_button_fast_path_EXISTS 1
+#define DT_N_S_trackball_listener_P_abs_rate_control 0
+#define DT_N_S_trackball_listener_P_abs_rate_control_EXISTS 1
+#define DT_N_S_trackball_listener_P_abs_deadzone 0
+#define DT_N_S_trackball_listener_P_abs_deadzone_EXISTS 1
+#define DT_N_S_trackball_listener_P_abs_rate_period_ms 10
+#define DT_N_S_trackball_listener_P_abs_rate_period_ms_EXISTS 1
+#define DT_N_S_trackball_listener_P_abs_center_x 0
+#define DT_N_S_trackball_listener_P_abs_center_x_EXISTS 1
+#define DT_N_S_trackball_listener_P_abs_center_y 0
+#define DT_N_S_trackball_listener_P_abs_center_y_EXISTS 1
+#define DT_N_S_trackball_listener_P_evt_type 2
+#define DT_N_S_trackball_listener_P_evt_type_EXISTS 1
+#define DT_N_S_trackball_listener_P_x_input_code 0
+#define DT_N_S_trackball_listener_P_x_input_code_EXISTS 1
+#define DT_N_S_trackball_listener_P_y_input_code 1
+#define DT_N_S_trackball_listener_P_y_input_code_EXISTS 1
+#define DT_N_S_trackball_listener_P_layers_IDX_0 1
+#define DT_N_S_trackball_listener_P_layers_LEN 1
+#define DT_N_S_trackball_listener_P_layers_EXISTS 1
+#define DT_N_S_trackball_listener_P_layers_FOREACH_PROP_ELEM(fn)                                   \
+    fn(DT_N_S_trackball_listener, layers, 0)
+#define DT_N_S_trackball_listener_P_bindings_IDX_0_PH DT_N_S_behaviors_S_input_behavior_smoother
+#define DT_N_S_trackball_listener_P_bindings_IDX_1_PH DT_N_S_behaviors_S_input_behavior_accel
+#define DT_N_S_trackball_listener_P_bindings_LEN 2
+#define DT_N_S_trackball_listener_P_bindings_EXISTS 1
+#define DT_N_S_trackball_listener_FOREACH_CHILD(fn)                                                \
+    fn(DT_N_S_trackball_listener_S_tilt) fn(DT_N_S_trackball_listener_S_scroll)
+#define DT_N_S_trackball_listener_FOREACH_CHILD_VARGS(fn, ...)                                     \
+    fn(DT_N_S_trackball_listener_S_tilt, __VA_ARGS__)                                              \
+    fn(DT_N_S_trackball_listener_S_scroll, __VA_ARGS__)
+
+// trackball_listener/tilt
+#define DT_N_S_trackball_listener_S_tilt_ORD 14
+#define DT_N_S_trackball_listener_S_tilt_FULL_NAME "tilt"
+#define DT_N_S_trackball_listener_S_tilt_STATUS_okay 1
+#define DT_N_S_trackball_listener_S_tilt_P_xy_swap 0
+#define DT_N_S_trackball_listener_S_tilt_P_xy_swap_EXISTS 1
+#define DT_N_S_trackball_listener_S_tilt_P_x_invert 0
+#define DT_N_S_trackball_listener_S_tilt_P_x_invert_EXISTS 1
+#define DT_N_S_trackball_listener_S_tilt_P_y_invert 0
+#define DT_N_S_trackball_listener_S_tilt_P_y_invert_EXISTS 1
+#define DT_N_S_trackball_listener_S_tilt_P_rotate_deg -30
+#define DT_N_S_trackball_listener_S_tilt_P_rotate_deg_EXISTS 1
+#define DT_N_S_trackball_listener_S_tilt_P_layers_IDX_0 0
+#define DT_N_S_trackball_listener_S_tilt_P_layers_LEN 1
+#define DT_N_S_trackball_listener_S_tilt_P_layers_EXISTS 1
+#define DT_N_S_trackball_listener_S_tilt_P_layers_FOREACH_PROP_ELEM(fn)                            \
+    fn(DT_N_S_trackball_listener_S_tilt, layers, 0)
+#define DT_N_S_trackball_listener_S_tilt_FOREACH_CHILD(fn)
+#define DT_N_S_trackball_listener_S_tilt_FOREACH_CHILD_VARGS(fn, ...)
+
+// trackball_listener/scroll
+#define DT_N_S_trackball_listener_S_scroll_ORD 15
+#define DT_N_S_trackball_listener_S_scroll_FULL_NAME "scroll"
+#define DT_N_S_trackball_listener_S_scroll_STATUS_okay 1
+#define DT_N_S_trackball_listener_S_scroll_P_xy_swap 0
+#define DT_N_S_trackball_listener_S_scroll_P_xy_swap_EXISTS 1
+#define DT_N_S_trackball_listener_S_scroll_P_x_invert 0
+#define DT_N_S_trackball_listener_S_scroll_P_x_invert_EXISTS 1
+#define DT_N_S_trackball_listener_S_scroll_P_y_invert 1
+#define DT_N_S_trackball_listener_S_scroll_P_y_invert_EXISTS 1
+#define DT_N_S_trackball_listener_S_scroll_P_x_input_code 6
+#define DT_N_S_trackball_listener_S_scroll_P_x_input_code_EXISTS 1
+#define DT_N_S_trackball_listener_S_scroll_P_y_input_code 8
+#define DT_N_S_trackball_listener_S_scroll_P_y_input_code_EXISTS 1
+#define DT_N_S_trackball_listener_S_scroll_P_scroll_counts_per_detent 4
+#define DT_N_S_trackball_listener_S_scroll_P_scroll_counts_per_detent_EXISTS 1
+#define DT_N_S_trackball_listener_S_scroll_P_layers_IDX_0 2
+#define DT_N_S_trackball_listener_S_scroll_P_layers_LEN 1
+#define DT_N_S_trackball_listener_S_scroll_P_layers_EXISTS 1
+#define DT_N_S_trackball_listener_S_scroll_P_layers_FOREACH_PROP_ELEM(fn)                          \
+    fn(DT_N_S_trackball_listener_S_scroll, layers, 0)
+#define DT_N_S_trackball_listener_S_scroll_FOREACH_CHILD(fn)
+#define DT_N_S_trackball_listener_S_scroll_FOREACH_CHILD_VARGS(fn, ...)
+
+// instances of zmk,input-behavior-smoother
+#define DT_N_INST_0_zmk_input_behavior_smoother DT_N_S_behaviors_S_input_behavior_smoother
+#define DT_COMPAT_HAS_OKAY_zmk_input_behavior_smoother 1
+#define DT_FOREACH_OKAY_INST_zmk_input_behavior_smoother(fn) fn(0)
+
+// instances of zmk,input-behavior-accel
+#define DT_N_INST_0_zmk_input_behavior_accel DT_N_S_behaviors_S_input_behavior_accel
+#define DT_COMPAT_HAS_OKAY_zmk_input_behavior_accel 1
+#define DT_FOREACH_OKAY_INST_zmk_input_behavior_accel(fn) fn(0)
+
+// instances of zmk,input-behavior-listener
+#define DT_N_INST_0_zmk_input_behavior_listener DT_N_S_trackball_listener
+#define DT_COMPAT_HAS_OKAY_zmk_input_behavior_listener 1
+#define DT_FOREACH_OKAY_INST_zmk_input_behavior_listener(fn) fn(0)
+
+// the device the harness reports input from
+#define HARNESS_INPUT_NODE DT_N_S_trackball
@@ -0,0 +1,63 @@
+# Copyright (c) 2024 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+#
+# Time the frames of an executable against a reference built on the same host, and
+# fail when the ratio grew by half over the baseline. The ratio, in percent, keeps
+# the check independent of the speed of the host. The best median of a few runs is
+# taken, as the host may preempt any single one.
+#
+#   cmake -DEXE=<executable> -DREF=<executable> -DNAME=<name> -DBASELINE=<file> -P bench.cmake
+
+set(frames 20000)
+set(runs 7)
+set(tolerance 150)
+
+function(run_median exe out)
+  execute_process(COMMAND ${exe} --bench=${frames}
+    OUTPUT_VARIABLE output RESULT_VARIABLE result)
+  if(NOT result EQUAL 0 OR NOT output MATCHES "median ([0-9]+)")
+    message(FATAL_ERROR "${exe} failed (${result}):\n${output}")
+  endif()
+  set(${out} ${CMAKE_MATCH_1} PARENT_SCOPE)
+endfunction()
+
+# runs of the two alternate, so a slow spell of the host hits both of them alike
+set(ref 0)
+set(exe 0)
+foreach(run RANGE 1 ${runs})
+  run_median(${REF} median)
+  if(ref EQUAL 0 OR median LESS ref)
+    set(ref ${median})
+  endif()
+  run_median(${EXE} median)
+  if(exe EQUAL 0 OR median LESS exe)
+    set(exe ${median})
+  endif()
+endforeach()
+math(EXPR ratio "${exe} * 100 / ${ref}")
+message("${NAME}: ${exe} cycles/frame, ${ref} for the plain listener, ${ratio}%")
+
+set(lines "")
+if(EXISTS ${BASELINE})
+  file(STRINGS ${BASELINE} lines)
+endif()
+
+if(DEFINED ENV{IBL_UPDATE_BASELINE})
+  list(FILTER lines EXCLUDE REGEX "^${NAME} ")
+  list(APPEND lines "${NAME} ${ratio}")
+  list(SORT lines)
+  list(JOIN lines "\n" content)
+  file(WRITE ${BASELINE} "${content}\n")
+  message(STATUS "Updated ${NAME} in ${BASELINE}")
+  return()
+endif()
+
+list(FILTER lines INCLUDE REGEX "^${NAME} ")
+if(NOT lines MATCHES "^${NAME} ([0-9]+)$")
+  message(FATAL_ERROR "No baseline for ${NAME} in ${BASELINE}")
+endif()
+set(expected ${CMAKE_MATCH_1})
+math(EXPR limit "${expected} * ${tolerance} / 100")
+if(ratio GREATER limit)
+  message(FATAL_ERROR "${NAME} takes ${ratio}% of the plain listener, baseline ${expected}%")
+endif()
@@ -0,0 +1,60 @@
+# Copyright (c) 2024 The ZMK Contributors
+# SPDX-License-Identifier: MIT
+#
+# Run a harness executable and compare what it prints with its baseline, or write the
+# baseline when IBL_UPDATE_BASELINE is set in the environment. Cycle counts of the stats
+# command depend on the host and are masked.
+#
+#   cmake -DEXE=<executable> -DBASELINE=<file> -DOUTPUT=<file> -DARGS=<args> -P compare.cmake
+
+execute_process(COMMAND ${EXE} ${ARGS}
+  OUTPUT_VARIABLE output ERROR_VARIABLE errors RESULT_VARIABLE result)
+string(REGEX REPLACE "(cycles/[a-z]+) avg [0-9]+ max [0-9]+" "\\1 avg * max *" output "${output}")
+file(WRITE ${OUTPUT} "${output}")
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "${EXE} failed (${result}):\n${errors}")
+endif()
+if(errors)
+  message("${errors}")
+endif()
+
+if(DEFINED ENV{IBL_UPDATE_BASELINE})
+  file(WRITE ${BASELINE} "${output}")
+  message(STATUS "Updated ${BASELINE}")
+  return()
+endif()
+
+if(NOT EXISTS ${BASELINE})
+  message(FATAL_ERROR "No baseline ${BASELINE}, run with IBL_UPDATE_BASELINE=1 to write it")
+endif()
+file(READ ${BASELINE} expected)
+if(output STREQUAL expected)
+  return()
+endif()
+
+# report the first line that differs
+string(REPLACE "\n" ";" output_lines "${output}")
+string(REPLACE "\n" ";" expected_lines "${expected}")
+list(LENGTH output_lines output_len)
+list(LENGTH expected_lines expected_len)
+set(line 0)
+while(line LESS output_len AND line LESS expected_len)
+  list(GET output_lines ${line} got)
+  list(GET expected_lines ${line} want)
+  if(NOT got STREQUAL want)
+    break()
+  endif()
+  math(EXPR line "${line} + 1")
+endwhile()
+set(got "<end of output>")
+set(want "<end of baseline>")
+if(line LESS output_len)
+  list(GET output_lines ${line} got)
+endif()
+if(line LESS expected_len)
+  list(GET expected_lines ${line} want)
+endif()
+math(EXPR line "${line} + 1")
+message(FATAL_ERROR "Output differs from ${BASELINE} at line ${line}:\n"
+  "  expected: ${want}\n  got:      ${got}\n"
+  "Full output in ${OUTPUT}")
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for ZMK's <drivers/behavior.h>.
+
+#pragma once
+
+#include <zephyr/device.h>
+#include <zmk/behavior.h>
+
+struct zmk_sensor_config;
+
+struct sensor_value {
+    // pointer sized on the host, as the listener passes the input event in it
+    intptr_t val1;
+    int32_t val2;
+};
+
+#define SENSOR_CHAN_ALL 0
+
+struct zmk_sensor_channel_data {
+    struct sensor_value value;
+    int channel;
+};
+
+enum behavior_sensor_binding_process_mode {
+    BEHAVIOR_SENSOR_BINDING_PROCESS_MODE_TRIGGER,
+    BEHAVIOR_SENSOR_BINDING_PROCESS_MODE_DISCARD,
+};
+
+typedef int (*behavior_keymap_binding_callback_t)(struct zmk_behavior_binding *binding,
+                                                  struct zmk_behavior_binding_event event);
+typedef int (*behavior_sensor_keymap_binding_accept_data_callback_t)(
+    struct zmk_behavior_binding *binding, struct zmk_behavior_binding_event event,
+    const struct zmk_sensor_config *sensor_config, size_t channel_data_size,
+    const struct zmk_sensor_channel_data *channel_data);
+typedef int (*behavior_sensor_keymap_binding_process_callback_t)(
+    struct zmk_behavior_binding *binding, struct zmk_behavior_binding_event event,
+    enum behavior_sensor_binding_process_mode mode);
+
+struct behavior_driver_api {
+    behavior_keymap_binding_callback_t binding_pressed;
+    behavior_keymap_binding_callback_t binding_released;
+    behavior_sensor_keymap_binding_accept_data_callback_t sensor_binding_accept_data;
+    behavior_sensor_keymap_binding_process_callback_t sensor_binding_process;
+};
+
+#define BEHAVIOR_DT_INST_DEFINE(inst, ...) DEVICE_DT_INST_DEFINE(inst, __VA_ARGS__)
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Controls of the host harness over its stand-ins for Zephyr and ZMK.
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/mouse/resolution_multipliers.h>
+
+// run the device and SYS_INIT functions, in level and priority order
+int harness_init(void);
+
+// move the virtual clock forward, running delayable work as its deadline comes up
+void harness_advance_to(int64_t ms);
+
+// run a shell command line, e.g. "input_listener record dump"
+int harness_shell_exec(const char *line);
+
+// print each mouse report and layer change to stdout, on by default
+extern bool harness_print_reports;
+
+// mouse reports sent so far
+extern uint32_t harness_reports;
+
+// resolution multipliers the host enabled, 0 to 15 for 1 to 16
+extern struct zmk_mouse_resolution_multipliers harness_resolution_multipliers;
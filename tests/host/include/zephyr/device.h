@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <zephyr/device.h>. Devices and SYS_INIT functions register themselves
+// before main() and are initialized by harness_init() in level and priority order.
+
+#pragma once
+
+#include <zephyr/devicetree.h>
+
+struct device {
+    const char *name;
+    const void *config;
+    const void *api;
+    void *data;
+};
+
+enum z_init_level {
+    Z_INIT_PRE_KERNEL_1,
+    Z_INIT_POST_KERNEL,
+    Z_INIT_APPLICATION,
+};
+
+void z_init_register(enum z_init_level level, int prio, int (*init_fn)(void),
+                     int (*dev_init_fn)(const struct device *dev), const struct device *dev);
+
+#define Z_INIT_LEVEL(level) _CONCAT(Z_INIT_, level)
+
+#define Z_DEVICE_NAME(node_id) DT_CAT(__device_, node_id)
+
+#define DEVICE_DT_NAME(node_id) DT_NODE_FULL_NAME(node_id)
+#define DEVICE_DT_GET(node_id) (&Z_DEVICE_NAME(node_id))
+#define DEVICE_DT_INST_GET(inst) DEVICE_DT_GET(DT_DRV_INST(inst))
+#define DEVICE_DT_DECLARE(node_id) extern const struct device Z_DEVICE_NAME(node_id)
+
+#define DEVICE_DT_DEFINE(node_id, init_fn, pm, data_ptr, cfg_ptr, level, prio, api_ptr, ...)      \
+    Z_DEVICE_DT_DEFINE(node_id, Z_DEVICE_NAME(node_id), init_fn, data_ptr, cfg_ptr, level, prio,   \
+                       api_ptr)
+
+#define Z_DEVICE_DT_DEFINE(node_id, dev_name, init_fn, data_ptr, cfg_ptr, level, prio, api_ptr)    \
+    const struct device dev_name = {                                                               \
+        .name = DEVICE_DT_NAME(node_id),                                                           \
+        .config = (cfg_ptr),                                                                       \
+        .api = (api_ptr),                                                                          \
+        .data = (data_ptr),                                                                        \
+    };                                                                                             \
+    __attribute__((constructor)) static void _CONCAT(dev_name, _register)(void) {                  \
+        z_init_register(Z_INIT_LEVEL(level), (prio), NULL, (init_fn), &dev_name);                  \
+    }
+
+#define DEVICE_DT_INST_DEFINE(inst, ...) DEVICE_DT_DEFINE(DT_DRV_INST(inst), __VA_ARGS__)
+
+#define SYS_INIT(init_fn, level, prio)                                                             \
+    __attribute__((constructor)) static void _CONCAT(init_fn, _register)(void) {                   \
+        z_init_register(Z_INIT_LEVEL(level), (prio), (init_fn), NULL, NULL);                       \
+    }
+
+const struct device *device_get_binding(const char *name);
+
+static inline bool device_is_ready(const struct device *dev) { return dev != NULL; }
+
+// every node of the board may be a device, declare them all for DEVICE_DT_GET
+#define Z_DEVICE_DT_DECLARE(node_id) DEVICE_DT_DECLARE(node_id);
+DT_FOREACH_NODE(Z_DEVICE_DT_DECLARE)
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <zephyr/devicetree.h>. Nodes are described by a board header in
+// tests/host/boards, with the macro names of Zephyr's generated devicetree_generated.h:
+//   <node>_P_<prop>, <node>_P_<prop>_EXISTS, <node>_P_<prop>_LEN,
+//   <node>_P_<prop>_IDX_<i>, <node>_P_<prop>_IDX_<i>_PH, <node>_P_<prop>_IDX_<i>_VAL_<cell>,
+//   <node>_P_<prop>_FOREACH_PROP_ELEM(fn), <node>_FOREACH_CHILD(fn),
+//   <node>_FOREACH_CHILD_VARGS(fn, ...), <node>_ORD, <node>_FULL_NAME, <node>_STATUS_okay,
+//   DT_N_INST_<inst>_<compat>, DT_COMPAT_HAS_OKAY_<compat> and DT_FOREACH_OKAY_INST_<compat>(fn),
+// plus DT_FOREACH_NODE(fn) over every node, so each may be declared as a device.
+
+#pragma once
+
+#include <zephyr/sys/util.h>
+
+#define DT_CAT(a1, a2) a1##a2
+#define DT_CAT3(a1, a2, a3) a1##a2##a3
+#define DT_CAT4(a1, a2, a3, a4) a1##a2##a3##a4
+#define DT_CAT5(a1, a2, a3, a4, a5) a1##a2##a3##a4##a5
+#define DT_CAT6(a1, a2, a3, a4, a5, a6) a1##a2##a3##a4##a5##a6
+#define DT_CAT7(a1, a2, a3, a4, a5, a6, a7) a1##a2##a3##a4##a5##a6##a7
+#define DT_CAT8(a1, a2, a3, a4, a5, a6, a7, a8) a1##a2##a3##a4##a5##a6##a7##a8
+
+#define DT_INST(inst, compat) DT_CAT4(DT_N_INST_, inst, _, compat)
+#define DT_DRV_INST(inst) DT_INST(inst, DT_DRV_COMPAT)
+
+#define DT_PROP(node_id, prop) DT_CAT3(node_id, _P_, prop)
+#define DT_NODE_HAS_PROP(node_id, prop) IS_ENABLED(DT_CAT4(node_id, _P_, prop, _EXISTS))
+#define DT_PROP_OR(node_id, prop, default_value)                                                   \
+    COND_CODE_1(DT_NODE_HAS_PROP(node_id, prop), (DT_PROP(node_id, prop)), (default_value))
+#define DT_PROP_LEN(node_id, prop) DT_CAT4(node_id, _P_, prop, _LEN)
+#define DT_PROP_LEN_OR(node_id, prop, default_value)                                               \
+    COND_CODE_1(DT_NODE_HAS_PROP(node_id, prop), (DT_PROP_LEN(node_id, prop)), (default_value))
+#define DT_PROP_BY_IDX(node_id, prop, idx) DT_CAT5(node_id, _P_, prop, _IDX_, idx)
+#define DT_FOREACH_PROP_ELEM(node_id, prop, fn) DT_CAT4(node_id, _P_, prop, _FOREACH_PROP_ELEM)(fn)
+
+#define DT_PHANDLE_BY_IDX(node_id, prop, idx) DT_CAT6(node_id, _P_, prop, _IDX_, idx, _PH)
+#define DT_PHANDLE(node_id, prop) DT_PHANDLE_BY_IDX(node_id, prop, 0)
+#define DT_PHA_BY_IDX(node_id, pha, idx, cell) DT_CAT7(node_id, _P_, pha, _IDX_, idx, _VAL_, cell)
+#define DT_PHA_HAS_CELL_AT_IDX(node_id, pha, idx, cell)                                            \
+    IS_ENABLED(DT_CAT8(node_id, _P_, pha, _IDX_, idx, _VAL_, cell, _EXISTS))
+
+#define DT_FOREACH_CHILD(node_id, fn) DT_CAT(node_id, _FOREACH_CHILD)(fn)
+#define DT_FOREACH_CHILD_VARGS(node_id, fn, ...) DT_CAT(node_id, _FOREACH_CHILD_VARGS)(fn, __VA_ARGS__)
+
+#define DT_DEP_ORD(node_id) DT_CAT(node_id, _ORD)
+#define DT_NODE_FULL_NAME(node_id) DT_CAT(node_id, _FULL_NAME)
+#define DT_NODE_HAS_STATUS(node_id, status) IS_ENABLED(DT_CAT3(node_id, _STATUS_, status))
+#define DT_HAS_COMPAT_STATUS_OKAY(compat) IS_ENABLED(DT_CAT(DT_COMPAT_HAS_OKAY_, compat))
+
+#define DT_INST_PROP(inst, prop) DT_PROP(DT_DRV_INST(inst), prop)
+#define DT_INST_PROP_OR(inst, prop, default_value) DT_PROP_OR(DT_DRV_INST(inst), prop, default_value)
+#define DT_INST_PROP_LEN(inst, prop) DT_PROP_LEN(DT_DRV_INST(inst), prop)
+#define DT_INST_NODE_HAS_PROP(inst, prop) DT_NODE_HAS_PROP(DT_DRV_INST(inst), prop)
+#define DT_INST_PHANDLE(inst, prop) DT_PHANDLE(DT_DRV_INST(inst), prop)
+#define DT_INST_FOREACH_CHILD(inst, fn) DT_FOREACH_CHILD(DT_DRV_INST(inst), fn)
+#define DT_INST_FOREACH_CHILD_VARGS(inst, fn, ...)                                                 \
+    DT_FOREACH_CHILD_VARGS(DT_DRV_INST(inst), fn, __VA_ARGS__)
+#define DT_INST_FOREACH_STATUS_OKAY(fn)                                                           \
+    COND_CODE_1(DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT),                                          \
+                (UTIL_CAT(DT_FOREACH_OKAY_INST_, DT_DRV_COMPAT)(fn)), ())
+
+// devicetree of the board the harness is built for
+#include <board.h>
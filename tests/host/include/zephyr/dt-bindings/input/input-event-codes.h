@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Values of Zephyr's <zephyr/dt-bindings/input/input-event-codes.h> the harness uses.
+
+#pragma once
+
+#define INPUT_EV_KEY 0x01
+#define INPUT_EV_REL 0x02
+#define INPUT_EV_ABS 0x03
+#define INPUT_EV_MSC 0x04
+
+#define INPUT_REL_X 0x00
+#define INPUT_REL_Y 0x01
+#define INPUT_REL_Z 0x02
+#define INPUT_REL_HWHEEL 0x06
+#define INPUT_REL_WHEEL 0x08
+#define INPUT_REL_MISC 0x09
+
+#define INPUT_ABS_X 0x00
+#define INPUT_ABS_Y 0x01
+
+#define INPUT_BTN_0 0x100
+#define INPUT_BTN_1 0x101
+#define INPUT_BTN_2 0x102
+#define INPUT_BTN_3 0x103
+#define INPUT_BTN_4 0x104
+#define INPUT_BTN_8 0x108
+#define INPUT_BTN_TOUCH 0x14a
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <zephyr/input/input.h>. Reports are delivered synchronously to the
+// callbacks of the device, in the order they were defined.
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/dt-bindings/input/input-event-codes.h>
+
+struct input_event {
+    const struct device *dev;
+    uint8_t sync;
+    uint8_t type;
+    uint16_t code;
+    int32_t value;
+};
+
+struct input_callback {
+    const struct device *dev;
+    void (*callback)(struct input_event *evt);
+    struct input_callback *next;
+};
+
+void z_input_callback_register(struct input_callback *cb);
+
+#define INPUT_CALLBACK_DEFINE(_dev, _callback)                                                     \
+    static struct input_callback _CONCAT(_input_callback__, _callback) = {                         \
+        .dev = (_dev),                                                                             \
+        .callback = (_callback),                                                                   \
+    };                                                                                             \
+    __attribute__((constructor)) static void _CONCAT(_input_callback_register__, _callback)(void) { \
+        z_input_callback_register(&_CONCAT(_input_callback__, _callback));                         \
+    }
+
+int input_report(const struct device *dev, uint8_t type, uint16_t code, int32_t value, bool sync,
+                 k_timeout_t timeout);
+
+static inline int input_report_key(const struct device *dev, uint16_t code, int32_t value,
+                                   bool sync, k_timeout_t timeout) {
+    return input_report(dev, INPUT_EV_KEY, code, !!value, sync, timeout);
+}
+
+static inline int input_report_rel(const struct device *dev, uint16_t code, int32_t value,
+                                   bool sync, k_timeout_t timeout) {
+    return input_report(dev, INPUT_EV_REL, code, value, sync, timeout);
+}
+
+static inline int input_report_abs(const struct device *dev, uint16_t code, int32_t value,
+                                   bool sync, k_timeout_t timeout) {
+    return input_report(dev, INPUT_EV_ABS, code, value, sync, timeout);
+}
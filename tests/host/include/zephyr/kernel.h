@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <zephyr/kernel.h>. Time is virtual and only moves when the harness
+// advances it, delayable work runs from harness_advance_to() once its deadline is due,
+// and threads are coroutines which only switch in k_sem_take() and k_sem_give(), so
+// locks and atomics are plain.
+
+#pragma once
+
+#include <errno.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/device.h>
+
+#ifndef CONFIG_SYS_CLOCK_TICKS_PER_SEC
+#define CONFIG_SYS_CLOCK_TICKS_PER_SEC 1000
+#endif
+#define CONFIG_KERNEL_INIT_PRIORITY_DEFAULT 40
+#define CONFIG_APPLICATION_INIT_PRIORITY 90
+#define CONFIG_INPUT_INIT_PRIORITY 90
+#define CONFIG_ZMK_LOG_LEVEL 3
+
+typedef int64_t k_ticks_t;
+
+typedef struct {
+    k_ticks_t ticks;
+} k_timeout_t;
+
+// one tick is one millisecond
+#define K_TICKS(t) ((k_timeout_t){.ticks = (t)})
+#define K_MSEC(ms) K_TICKS((ms) * CONFIG_SYS_CLOCK_TICKS_PER_SEC / 1000)
+#define K_USEC(us) K_TICKS((us) * CONFIG_SYS_CLOCK_TICKS_PER_SEC / 1000000)
+#define K_NO_WAIT K_TICKS(0)
+#define K_FOREVER K_TICKS(-1)
+
+#define k_ticks_to_ms_floor32(t) ((uint32_t)((t) * 1000 / CONFIG_SYS_CLOCK_TICKS_PER_SEC))
+#define k_ticks_to_us_floor32(t) ((uint32_t)((t) * 1000000 / CONFIG_SYS_CLOCK_TICKS_PER_SEC))
+#define k_ticks_to_us_floor64(t) ((uint64_t)(t) * 1000000 / CONFIG_SYS_CLOCK_TICKS_PER_SEC)
+#define k_ms_to_ticks_ceil32(ms) ((uint32_t)(ms) * CONFIG_SYS_CLOCK_TICKS_PER_SEC / 1000)
+
+int64_t k_uptime_ticks(void);
+static inline int64_t k_uptime_get(void) { return k_ticks_to_ms_floor32(k_uptime_ticks()); }
+static inline uint32_t k_uptime_get_32(void) { return (uint32_t)k_uptime_get(); }
+static inline int64_t k_uptime_delta(int64_t *reftime) {
+    int64_t now = k_uptime_get(), delta = now - *reftime;
+    *reftime = now;
+    return delta;
+}
+
+// cycles are real, read from the time stamp counter of the host
+uint32_t k_cycle_get_32(void);
+uint32_t sys_clock_hw_cycles_per_sec(void);
+static inline uint32_t k_cyc_to_us_floor32(uint32_t cyc) {
+    return (uint32_t)((uint64_t)cyc * 1000000 / sys_clock_hw_cycles_per_sec());
+}
+static inline uint64_t k_cyc_to_ns_floor64(uint64_t cyc) {
+    return cyc * 1000000000 / sys_clock_hw_cycles_per_sec();
+}
+
+int32_t k_sleep(k_timeout_t timeout);
+static inline int32_t k_msleep(int32_t ms) { return k_sleep(K_MSEC(ms)); }
+static inline void k_yield(void) {}
+static inline bool k_is_in_isr(void) { return false; }
+
+static inline unsigned int find_lsb_set(uint32_t op) { return __builtin_ffs(op); }
+static inline unsigned int find_msb_set(uint32_t op) { return op ? 32 - __builtin_clz(op) : 0; }
+
+#define __ASSERT(cond, ...) ((void)(cond))
+#define __ASSERT_NO_MSG(cond) ((void)(cond))
+#define compiler_barrier() __asm__ volatile("" ::: "memory")
+
+struct k_work;
+typedef void (*k_work_handler_t)(struct k_work *work);
+
+struct k_work {
+    k_work_handler_t handler;
+};
+
+struct k_work_delayable {
+    struct k_work work;
+    k_ticks_t deadline;
+    bool pending;
+    struct k_work_delayable *next;
+};
+
+void k_work_init(struct k_work *work, k_work_handler_t handler);
+int k_work_submit(struct k_work *work);
+void k_work_init_delayable(struct k_work_delayable *dwork, k_work_handler_t handler);
+int k_work_schedule(struct k_work_delayable *dwork, k_timeout_t delay);
+int k_work_reschedule(struct k_work_delayable *dwork, k_timeout_t delay);
+int k_work_cancel_delayable(struct k_work_delayable *dwork);
+static inline bool k_work_delayable_is_pending(const struct k_work_delayable *dwork) {
+    return dwork->pending;
+}
+static inline k_ticks_t k_work_delayable_remaining_get(const struct k_work_delayable *dwork) {
+    return dwork->pending ? MAX(dwork->deadline - k_uptime_ticks(), 0) : 0;
+}
+static inline struct k_work_delayable *k_work_delayable_from_work(struct k_work *work) {
+    return CONTAINER_OF(work, struct k_work_delayable, work);
+}
+
+struct k_mutex {
+    int lock_count;
+};
+
+#define K_MUTEX_DEFINE(name) struct k_mutex name = {.lock_count = 0}
+
+static inline int k_mutex_init(struct k_mutex *mutex) {
+    mutex->lock_count = 0;
+    return 0;
+}
+static inline int k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout) {
+    mutex->lock_count++;
+    return 0;
+}
+static inline int k_mutex_unlock(struct k_mutex *mutex) {
+    mutex->lock_count--;
+    return 0;
+}
+
+struct k_spinlock {
+    int unused;
+};
+typedef int k_spinlock_key_t;
+
+static inline k_spinlock_key_t k_spin_lock(struct k_spinlock *lock) { return 0; }
+static inline void k_spin_unlock(struct k_spinlock *lock, k_spinlock_key_t key) {}
+
+struct harness_thread;
+
+struct k_sem {
+    unsigned int count;
+    unsigned int limit;
+    // thread blocked in k_sem_take() on it
+    struct harness_thread *waiter;
+};
+
+#define K_SEM_DEFINE(name, initial_count, count_limit)                                             \
+    struct k_sem name = {.count = (initial_count), .limit = (count_limit)}
+
+// a thread waiting on the semaphore runs right away, until it blocks again
+void k_sem_give(struct k_sem *sem);
+// blocks only a thread with K_FOREVER, returns -EBUSY otherwise
+int k_sem_take(struct k_sem *sem, k_timeout_t timeout);
+
+void z_thread_register(void (*entry)(void *, void *, void *), void *p1, void *p2, void *p3,
+                       size_t stack_size);
+
+// threads start at the end of harness_init(), in link order, whatever their priority
+#define K_PRIO_COOP(x) (-((x) + 1))
+#define K_PRIO_PREEMPT(x) (x)
+#define K_THREAD_DEFINE(name, stack_size, entry, p1, p2, p3, prio, options, delay)               \
+    __attribute__((constructor)) static void _CONCAT(name, _register)(void) {                      \
+        z_thread_register((entry), (p1), (p2), (p3), (stack_size));                                \
+    }
+
+typedef long atomic_t;
+typedef long atomic_val_t;
+
+static inline atomic_val_t atomic_get(const atomic_t *target) { return *target; }
+static inline atomic_val_t atomic_set(atomic_t *target, atomic_val_t value) {
+    atomic_val_t old = *target;
+    *target = value;
+    return old;
+}
+static inline atomic_val_t atomic_add(atomic_t *target, atomic_val_t value) {
+    atomic_val_t old = *target;
+    *target += value;
+    return old;
+}
+static inline atomic_val_t atomic_inc(atomic_t *target) { return atomic_add(target, 1); }
+static inline bool atomic_cas(atomic_t *target, atomic_val_t old_value, atomic_val_t new_value) {
+    if (*target != old_value) {
+        return false;
+    }
+    *target = new_value;
+    return true;
+}
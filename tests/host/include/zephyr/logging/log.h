@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <zephyr/logging/log.h>. Debug messages are dropped and the rest goes
+// to stderr, so it never mixes with the reports the harness prints to stdout.
+
+#pragma once
+
+#include <stdio.h>
+
+#define LOG_MODULE_REGISTER(...)
+#define LOG_MODULE_DECLARE(...)
+
+#define Z_LOG(level, fmt, ...) fprintf(stderr, "<" level "> " fmt "\n", ##__VA_ARGS__)
+
+#define LOG_DBG(...)                                                                               \
+    do {                                                                                           \
+        if (0) {                                                                                   \
+            Z_LOG("dbg", __VA_ARGS__);                                                             \
+        }                                                                                          \
+    } while (0)
+#define LOG_INF(...) Z_LOG("inf", __VA_ARGS__)
+#define LOG_WRN(...) Z_LOG("wrn", __VA_ARGS__)
+#define LOG_ERR(...) Z_LOG("err", __VA_ARGS__)
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <zephyr/shell/shell.h>. Commands register their static tree and
+// harness_shell_exec() runs a command line against it, printing to stdout.
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+struct shell {
+    const char *name;
+};
+
+typedef int (*shell_cmd_handler)(const struct shell *sh, size_t argc, char **argv);
+
+struct shell_static_entry {
+    const char *syntax;
+    const char *help;
+    const struct shell_static_entry *subcmd;
+    shell_cmd_handler handler;
+    uint8_t mandatory;
+    uint8_t optional;
+};
+
+void z_shell_cmd_register(const struct shell_static_entry *entry);
+
+void shell_print(const struct shell *sh, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+void shell_warn(const struct shell *sh, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+void shell_error(const struct shell *sh, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+#define SHELL_CMD_ARG(_syntax, _subcmd, _help, _handler, _mand, _opt)                              \
+    {                                                                                              \
+        .syntax = #_syntax,                                                                        \
+        .help = (_help),                                                                           \
+        .subcmd = (const struct shell_static_entry *)(_subcmd),                                    \
+        .handler = (_handler),                                                                     \
+        .mandatory = (_mand),                                                                      \
+        .optional = (_opt),                                                                        \
+    }
+#define SHELL_CMD(_syntax, _subcmd, _help, _handler) SHELL_CMD_ARG(_syntax, _subcmd, _help, _handler, 0, 0)
+#define SHELL_SUBCMD_SET_END {NULL}
+
+#define SHELL_STATIC_SUBCMD_SET_CREATE(name, ...)                                                  \
+    static const struct shell_static_entry name[] = {__VA_ARGS__}
+
+#define SHELL_CMD_ARG_REGISTER(_syntax, _subcmd, _help, _handler, _mand, _opt)                     \
+    static const struct shell_static_entry _CONCAT(_shell_root_, _syntax) =                        \
+        SHELL_CMD_ARG(_syntax, _subcmd, _help, _handler, _mand, _opt);                             \
+    __attribute__((constructor)) static void _CONCAT(_shell_register_, _syntax)(void) {            \
+        z_shell_cmd_register(&_CONCAT(_shell_root_, _syntax));                                     \
+    }
+#define SHELL_CMD_REGISTER(_syntax, _subcmd, _help, _handler)                                      \
+    SHELL_CMD_ARG_REGISTER(_syntax, _subcmd, _help, _handler, 0, 0)
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for the parts of <zephyr/sys/util.h> the module uses.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#define BIT(n) (1UL << (n))
+#define WRITE_BIT(var, bit, set) ((var) = (set) ? ((var) | BIT(bit)) : ((var) & ~BIT(bit)))
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+#define CONTAINER_OF(ptr, type, field) ((type *)(((char *)(ptr)) - offsetof(type, field)))
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#define CLAMP(val, low, high) (((val) <= (low)) ? (low) : MIN(val, high))
+#define IN_RANGE(val, min, max) ((val) >= (min) && (val) <= (max))
+#define IS_POWER_OF_TWO(x) (((x) != 0U) && (((x) & ((x) - 1U)) == 0U))
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+#define ARG_UNUSED(x) (void)(x)
+#define __unused __attribute__((unused))
+#define BUILD_ASSERT(cond, ...) _Static_assert(cond, "" __VA_ARGS__)
+
+#define STRINGIFY(s) Z_STRINGIFY(s)
+#define Z_STRINGIFY(s) #s
+#define _DO_CONCAT(x, y) x##y
+#define _CONCAT(x, y) _DO_CONCAT(x, y)
+#define UTIL_CAT(a, ...) UTIL_PRIMITIVE_CAT(a, __VA_ARGS__)
+#define UTIL_PRIMITIVE_CAT(a, ...) a##__VA_ARGS__
+
+#define _XXXX1 _YYYY,
+#define _ZZZZ0 _YYYY,
+#define IS_ENABLED(config_macro) Z_IS_ENABLED1(config_macro)
+#define Z_IS_ENABLED1(config_macro) Z_IS_ENABLED2(_XXXX##config_macro)
+#define Z_IS_ENABLED2(one_or_two_args) Z_IS_ENABLED3(one_or_two_args 1, 0)
+#define Z_IS_ENABLED3(ignore_this, val, ...) val
+
+#define COND_CODE_1(_flag, _if_1_code, _else_code)                                                 \
+    Z_COND_CODE_1(_flag, _if_1_code, _else_code)
+#define Z_COND_CODE_1(_flag, _if_1_code, _else_code)                                               \
+    Z_COND_CODE(_XXXX##_flag, _if_1_code, _else_code)
+#define COND_CODE_0(_flag, _if_0_code, _else_code)                                                 \
+    Z_COND_CODE_0(_flag, _if_0_code, _else_code)
+#define Z_COND_CODE_0(_flag, _if_0_code, _else_code)                                               \
+    Z_COND_CODE(_ZZZZ##_flag, _if_0_code, _else_code)
+#define Z_COND_CODE(one_or_two_args, _if_code, _else_code)                                         \
+    Z_GET_ARG2_DEBRACKET(one_or_two_args _if_code, _else_code)
+#define Z_GET_ARG2_DEBRACKET(ignore_this, val, ...) __DEBRACKET val
+#define __DEBRACKET(...) __VA_ARGS__
+#define IF_ENABLED(_flag, _code) COND_CODE_1(_flag, _code, ())
+
+#define LISTIFY(LEN, F, sep, ...) UTIL_CAT(Z_LISTIFY_, LEN)(F, sep, __VA_ARGS__)
+#define Z_LISTIFY_0(F, sep, ...)
+#define Z_LISTIFY_1(F, sep, ...) F(0, __VA_ARGS__)
+#define Z_LISTIFY_2(F, sep, ...) Z_LISTIFY_1(F, sep, __VA_ARGS__) __DEBRACKET sep F(1, __VA_ARGS__)
+#define Z_LISTIFY_3(F, sep, ...) Z_LISTIFY_2(F, sep, __VA_ARGS__) __DEBRACKET sep F(2, __VA_ARGS__)
+#define Z_LISTIFY_4(F, sep, ...) Z_LISTIFY_3(F, sep, __VA_ARGS__) __DEBRACKET sep F(3, __VA_ARGS__)
+#define Z_LISTIFY_5(F, sep, ...) Z_LISTIFY_4(F, sep, __VA_ARGS__) __DEBRACKET sep F(4, __VA_ARGS__)
+#define Z_LISTIFY_6(F, sep, ...) Z_LISTIFY_5(F, sep, __VA_ARGS__) __DEBRACKET sep F(5, __VA_ARGS__)
+#define Z_LISTIFY_7(F, sep, ...) Z_LISTIFY_6(F, sep, __VA_ARGS__) __DEBRACKET sep F(6, __VA_ARGS__)
+#define Z_LISTIFY_8(F, sep, ...) Z_LISTIFY_7(F, sep, __VA_ARGS__) __DEBRACKET sep F(7, __VA_ARGS__)
+#define Z_LISTIFY_9(F, sep, ...) Z_LISTIFY_8(F, sep, __VA_ARGS__) __DEBRACKET sep F(8, __VA_ARGS__)
+#define Z_LISTIFY_10(F, sep, ...) Z_LISTIFY_9(F, sep, __VA_ARGS__) __DEBRACKET sep F(9, __VA_ARGS__)
+#define Z_LISTIFY_11(F, sep, ...) Z_LISTIFY_10(F, sep, __VA_ARGS__) __DEBRACKET sep F(10, __VA_ARGS__)
+#define Z_LISTIFY_12(F, sep, ...) Z_LISTIFY_11(F, sep, __VA_ARGS__) __DEBRACKET sep F(11, __VA_ARGS__)
+#define Z_LISTIFY_13(F, sep, ...) Z_LISTIFY_12(F, sep, __VA_ARGS__) __DEBRACKET sep F(12, __VA_ARGS__)
+#define Z_LISTIFY_14(F, sep, ...) Z_LISTIFY_13(F, sep, __VA_ARGS__) __DEBRACKET sep F(13, __VA_ARGS__)
+#define Z_LISTIFY_15(F, sep, ...) Z_LISTIFY_14(F, sep, __VA_ARGS__) __DEBRACKET sep F(14, __VA_ARGS__)
+#define Z_LISTIFY_16(F, sep, ...) Z_LISTIFY_15(F, sep, __VA_ARGS__) __DEBRACKET sep F(15, __VA_ARGS__)
+#define Z_LISTIFY_17(F, sep, ...) Z_LISTIFY_16(F, sep, __VA_ARGS__) __DEBRACKET sep F(16, __VA_ARGS__)
+#define Z_LISTIFY_18(F, sep, ...) Z_LISTIFY_17(F, sep, __VA_ARGS__) __DEBRACKET sep F(17, __VA_ARGS__)
+#define Z_LISTIFY_19(F, sep, ...) Z_LISTIFY_18(F, sep, __VA_ARGS__) __DEBRACKET sep F(18, __VA_ARGS__)
+#define Z_LISTIFY_20(F, sep, ...) Z_LISTIFY_19(F, sep, __VA_ARGS__) __DEBRACKET sep F(19, __VA_ARGS__)
+#define Z_LISTIFY_21(F, sep, ...) Z_LISTIFY_20(F, sep, __VA_ARGS__) __DEBRACKET sep F(20, __VA_ARGS__)
+#define Z_LISTIFY_22(F, sep, ...) Z_LISTIFY_21(F, sep, __VA_ARGS__) __DEBRACKET sep F(21, __VA_ARGS__)
+#define Z_LISTIFY_23(F, sep, ...) Z_LISTIFY_22(F, sep, __VA_ARGS__) __DEBRACKET sep F(22, __VA_ARGS__)
+#define Z_LISTIFY_24(F, sep, ...) Z_LISTIFY_23(F, sep, __VA_ARGS__) __DEBRACKET sep F(23, __VA_ARGS__)
+#define Z_LISTIFY_25(F, sep, ...) Z_LISTIFY_24(F, sep, __VA_ARGS__) __DEBRACKET sep F(24, __VA_ARGS__)
+#define Z_LISTIFY_26(F, sep, ...) Z_LISTIFY_25(F, sep, __VA_ARGS__) __DEBRACKET sep F(25, __VA_ARGS__)
+#define Z_LISTIFY_27(F, sep, ...) Z_LISTIFY_26(F, sep, __VA_ARGS__) __DEBRACKET sep F(26, __VA_ARGS__)
+#define Z_LISTIFY_28(F, sep, ...) Z_LISTIFY_27(F, sep, __VA_ARGS__) __DEBRACKET sep F(27, __VA_ARGS__)
+#define Z_LISTIFY_29(F, sep, ...) Z_LISTIFY_28(F, sep, __VA_ARGS__) __DEBRACKET sep F(28, __VA_ARGS__)
+#define Z_LISTIFY_30(F, sep, ...) Z_LISTIFY_29(F, sep, __VA_ARGS__) __DEBRACKET sep F(29, __VA_ARGS__)
+#define Z_LISTIFY_31(F, sep, ...) Z_LISTIFY_30(F, sep, __VA_ARGS__) __DEBRACKET sep F(30, __VA_ARGS__)
+#define Z_LISTIFY_32(F, sep, ...) Z_LISTIFY_31(F, sep, __VA_ARGS__) __DEBRACKET sep F(31, __VA_ARGS__)
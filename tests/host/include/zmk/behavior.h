@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <zmk/behavior.h>. The listener passes the input event pointer as the
+// position of a binding event, so position is pointer sized on the host.
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#define ZMK_BEHAVIOR_OPAQUE 0
+#define ZMK_BEHAVIOR_TRANSPARENT 1
+
+struct zmk_behavior_binding {
+    const char *behavior_dev;
+    uint32_t param1;
+    uint32_t param2;
+};
+
+struct zmk_behavior_binding_event {
+    int layer;
+    uintptr_t position;
+    int64_t timestamp;
+};
+
+const struct device *zmk_behavior_get_binding(const char *name);
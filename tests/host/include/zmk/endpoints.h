@@ -0,0 +1,11 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <zmk/endpoints.h>, the harness prints each mouse report it is sent.
+
+#pragma once
+
+int zmk_endpoints_send_mouse_report(void);
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <zmk/event_manager.h>. Listeners are called in definition order for
+// the events they subscribed to, synchronously from the raising call.
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+struct zmk_event_type {
+    const char *name;
+};
+
+typedef struct {
+    const struct zmk_event_type *event;
+} zmk_event_t;
+
+#define ZMK_EV_EVENT_BUBBLE 0
+#define ZMK_EV_EVENT_HANDLED 1
+
+struct zmk_listener {
+    int (*callback)(const zmk_event_t *eh);
+};
+
+struct zmk_event_subscription {
+    const struct zmk_event_type *event_type;
+    const struct zmk_listener *listener;
+    struct zmk_event_subscription *next;
+};
+
+void z_zmk_event_subscribe(struct zmk_event_subscription *sub);
+int z_zmk_event_raise(const zmk_event_t *eh);
+
+#define ZMK_EVENT_DECLARE(event_type)                                                              \
+    struct event_type##_event {                                                                \
+        zmk_event_t header;                                                                        \
+        struct event_type data;                                                                    \
+    };                                                                                             \
+    extern const struct zmk_event_type zmk_event_##event_type;                                     \
+    static inline struct event_type *as_##event_type(const zmk_event_t *eh) {                      \
+        return (eh->event == &zmk_event_##event_type) ? &((struct event_type##_event *)eh)->data \
+                                                      : NULL;                                      \
+    }                                                                                              \
+    static inline int raise_##event_type(struct event_type data) {                                 \
+        struct event_type##_event ev = {.header = {.event = &zmk_event_##event_type},          \
+                                            .data = data};                                         \
+        return z_zmk_event_raise(&ev.header);                                                      \
+    }
+
+#define ZMK_EVENT_IMPL(event_type)                                                                 \
+    const struct zmk_event_type zmk_event_##event_type = {.name = #event_type}
+
+#define ZMK_LISTENER(mod, cb) static const struct zmk_listener zmk_listener_##mod = {.callback = cb}
+
+#define ZMK_SUBSCRIPTION(mod, ev_type)                                                             \
+    static struct zmk_event_subscription zmk_subscription_##mod##_##ev_type = {                    \
+        .event_type = &zmk_event_##ev_type,                                                        \
+        .listener = &zmk_listener_##mod,                                                           \
+    };                                                                                             \
+    __attribute__((constructor)) static void zmk_subscribe_##mod##_##ev_type(void) {               \
+        z_zmk_event_subscribe(&zmk_subscription_##mod##_##ev_type);                                \
+    }
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for the mouse part of <zmk/hid.h>, the harness keeps the report state.
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#define ZMK_MOUSE_HID_NUM_BUTTONS 0x05
+
+void zmk_hid_mouse_movement_set(int16_t x, int16_t y);
+void zmk_hid_mouse_scroll_set(int16_t x, int16_t y);
+int zmk_hid_mouse_button_press(uint8_t button);
+int zmk_hid_mouse_button_release(uint8_t button);
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <zmk/mouse/resolution_multipliers.h>, set by the harness.
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+struct zmk_mouse_resolution_multipliers {
+    uint8_t wheel;
+    uint8_t hor_wheel;
+};
+
+struct zmk_mouse_resolution_multipliers zmk_mouse_resolution_multipliers_get_current_profile(void);
@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Virtual clock, delayable work, threads, init levels, devices, input callbacks and the
+// shell of the host harness.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/input/input.h>
+#include <zephyr/shell/shell.h>
+
+#include <harness.h>
+
+#define MAX_INITS 32
+#define MAX_WORKS 32
+#define MAX_THREADS 4
+// stacks sized for the host, whatever the Kconfig size of the thread
+#define THREAD_STACK_SIZE (256 * 1024)
+#define MAX_SHELL_CMDS 8
+#define MAX_SHELL_ARGS 8
+
+static int64_t now_ticks;
+
+int64_t k_uptime_ticks(void) { return now_ticks; }
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+uint32_t k_cycle_get_32(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    return (uint32_t)monotonic_ns();
+#endif
+}
+
+uint32_t sys_clock_hw_cycles_per_sec(void) {
+    static uint32_t cycles_per_sec;
+    if (!cycles_per_sec) {
+        // calibrate the cycle counter against the monotonic clock over 10 ms
+        uint64_t start_ns = monotonic_ns();
+        uint32_t start = k_cycle_get_32();
+        while (monotonic_ns() - start_ns < 10000000) {
+        }
+        cycles_per_sec = (k_cycle_get_32() - start) * 100;
+    }
+    return cycles_per_sec;
+}
+
+// delayable work
+
+static struct k_work_delayable *works[MAX_WORKS];
+static size_t works_count;
+
+void k_work_init(struct k_work *work, k_work_handler_t handler) { work->handler = handler; }
+
+int k_work_submit(struct k_work *work) {
+    work->handler(work);
+    return 1;
+}
+
+void k_work_init_delayable(struct k_work_delayable *dwork, k_work_handler_t handler) {
+    *dwork = (struct k_work_delayable){.work = {.handler = handler}};
+    for (size_t i = 0; i < works_count; i++) {
+        if (works[i] == dwork) {
+            return;
+        }
+    }
+    if (works_count == MAX_WORKS) {
+        fprintf(stderr, "harness: too many delayable works\n");
+        abort();
+    }
+    works[works_count++] = dwork;
+}
+
+int k_work_reschedule(struct k_work_delayable *dwork, k_timeout_t delay) {
+    dwork->deadline = now_ticks + MAX(delay.ticks, 0);
+    dwork->pending = true;
+    return 1;
+}
+
+int k_work_schedule(struct k_work_delayable *dwork, k_timeout_t delay) {
+    if (dwork->pending) {
+        return 0;
+    }
+    return k_work_reschedule(dwork, delay);
+}
+
+int k_work_cancel_delayable(struct k_work_delayable *dwork) {
+    dwork->pending = false;
+    return 0;
+}
+
+static struct k_work_delayable *next_due_work(int64_t until) {
+    struct k_work_delayable *next = NULL;
+    for (size_t i = 0; i < works_count; i++) {
+        if (works[i]->pending && works[i]->deadline <= until &&
+            (!next || works[i]->deadline < next->deadline)) {
+            next = works[i];
+        }
+    }
+    return next;
+}
+
+void harness_advance_to(int64_t ms) {
+    int64_t until = MAX(ms * CONFIG_SYS_CLOCK_TICKS_PER_SEC / 1000, now_ticks);
+    struct k_work_delayable *dwork;
+    while ((dwork = next_due_work(until))) {
+        now_ticks = MAX(now_ticks, dwork->deadline);
+        dwork->pending = false;
+        dwork->work.handler(&dwork->work);
+    }
+    now_ticks = until;
+}
+
+int32_t k_sleep(k_timeout_t timeout) {
+    if (timeout.ticks > 0) {
+        harness_advance_to(k_ticks_to_ms_floor32(now_ticks + timeout.ticks));
+    }
+    return 0;
+}
+
+// threads
+
+struct harness_thread {
+    void (*entry)(void *, void *, void *);
+    void *p1, *p2, *p3;
+    ucontext_t context;
+};
+
+static struct harness_thread threads[MAX_THREADS];
+static size_t threads_count;
+static ucontext_t main_context;
+// NULL while the harness itself runs
+static struct harness_thread *current_thread;
+
+void z_thread_register(void (*entry)(void *, void *, void *), void *p1, void *p2, void *p3,
+                       size_t stack_size) {
+    if (threads_count == MAX_THREADS) {
+        fprintf(stderr, "harness: too many threads\n");
+        abort();
+    }
+    threads[threads_count++] = (struct harness_thread){
+        .entry = entry, .p1 = p1, .p2 = p2, .p3 = p3,
+    };
+}
+
+static void thread_main(void) {
+    current_thread->entry(current_thread->p1, current_thread->p2, current_thread->p3);
+    // like a Zephyr thread returning from its entry, it never runs again
+}
+
+// run the thread until it blocks, then continue the harness
+static void switch_to(struct harness_thread *thread) {
+    current_thread = thread;
+    swapcontext(&main_context, &thread->context);
+    current_thread = NULL;
+}
+
+static void start_threads(void) {
+    for (size_t i = 0; i < threads_count; i++) {
+        struct harness_thread *thread = &threads[i];
+        getcontext(&thread->context);
+        thread->context.uc_stack.ss_sp = malloc(THREAD_STACK_SIZE);
+        thread->context.uc_stack.ss_size = THREAD_STACK_SIZE;
+        thread->context.uc_link = &main_context;
+        makecontext(&thread->context, thread_main, 0);
+        switch_to(thread);
+    }
+}
+
+void k_sem_give(struct k_sem *sem) {
+    if (sem->count < sem->limit) {
+        sem->count++;
+    }
+    // a thread giving to another one only counts, the other runs on the next give
+    // from the harness
+    struct harness_thread *waiter = sem->waiter;
+    if (waiter && !current_thread) {
+        sem->waiter = NULL;
+        switch_to(waiter);
+    }
+}
+
+int k_sem_take(struct k_sem *sem, k_timeout_t timeout) {
+    while (!sem->count) {
+        if (!current_thread || timeout.ticks >= 0) {
+            return -EBUSY;
+        }
+        struct harness_thread *self = current_thread;
+        sem->waiter = self;
+        swapcontext(&self->context, &main_context);
+    }
+    sem->count--;
+    return 0;
+}
+
+// init levels and devices
+
+struct init_entry {
+    enum z_init_level level;
+    int prio;
+    int (*init_fn)(void);
+    int (*dev_init_fn)(const struct device *dev);
+    const struct device *dev;
+};
+
+static struct init_entry inits[MAX_INITS];
+static size_t inits_count;
+
+void z_init_register(enum z_init_level level, int prio, int (*init_fn)(void),
+                     int (*dev_init_fn)(const struct device *dev), const struct device *dev) {
+    if (inits_count == MAX_INITS) {
+        fprintf(stderr, "harness: too many init functions\n");
+        abort();
+    }
+    inits[inits_count++] = (struct init_entry){
+        .level = level, .prio = prio, .init_fn = init_fn, .dev_init_fn = dev_init_fn, .dev = dev,
+    };
+}
+
+static int init_entry_cmp(const void *a, const void *b) {
+    const struct init_entry *ea = a, *eb = b;
+    if (ea->level != eb->level) {
+        return ea->level < eb->level ? -1 : 1;
+    }
+    if (ea->prio != eb->prio) {
+        return ea->prio < eb->prio ? -1 : 1;
+    }
+    // keep the link order within a priority
+    return ea < eb ? -1 : 1;
+}
+
+int harness_init(void) {
+    qsort(inits, inits_count, sizeof(inits[0]), init_entry_cmp);
+    for (size_t i = 0; i < inits_count; i++) {
+        int ret = 0;
+        if (inits[i].dev_init_fn) {
+            ret = inits[i].dev_init_fn(inits[i].dev);
+        } else if (inits[i].init_fn) {
+            ret = inits[i].init_fn();
+        }
+        if (ret < 0) {
+            fprintf(stderr, "harness: init of %s failed (%d)\n",
+                    inits[i].dev ? inits[i].dev->name : "SYS_INIT", ret);
+            return ret;
+        }
+    }
+    start_threads();
+    return 0;
+}
+
+const struct device *device_get_binding(const char *name) {
+    for (size_t i = 0; i < inits_count; i++) {
+        if (inits[i].dev && strcmp(inits[i].dev->name, name) == 0) {
+            return inits[i].dev;
+        }
+    }
+    return NULL;
+}
+
+// input
+
+static struct input_callback *input_callbacks;
+
+void z_input_callback_register(struct input_callback *cb) {
+    struct input_callback **tail = &input_callbacks;
+    while (*tail) {
+        tail = &(*tail)->next;
+    }
+    *tail = cb;
+}
+
+int input_report(const struct device *dev, uint8_t type, uint16_t code, int32_t value, bool sync,
+                 k_timeout_t timeout) {
+    // like Zephyr, every callback of the device sees the same event
+    struct input_event evt = {
+        .dev = dev, .sync = sync, .type = type, .code = code, .value = value,
+    };
+    for (struct input_callback *cb = input_callbacks; cb; cb = cb->next) {
+        if (!cb->dev || cb->dev == dev) {
+            cb->callback(&evt);
+        }
+    }
+    return 0;
+}
+
+// shell
+
+static const struct shell harness_shell = {.name = "harness"};
+static const struct shell_static_entry *shell_cmds[MAX_SHELL_CMDS];
+static size_t shell_cmds_count;
+
+void z_shell_cmd_register(const struct shell_static_entry *entry) {
+    if (shell_cmds_count < MAX_SHELL_CMDS) {
+        shell_cmds[shell_cmds_count++] = entry;
+    }
+}
+
+static void shell_vprint(const char *prefix, const char *fmt, va_list args) {
+    fputs(prefix, stdout);
+    vprintf(fmt, args);
+    putchar('\n');
+}
+
+void shell_print(const struct shell *sh, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    shell_vprint("", fmt, args);
+    va_end(args);
+}
+
+void shell_warn(const struct shell *sh, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    shell_vprint("warning: ", fmt, args);
+    va_end(args);
+}
+
+void shell_error(const struct shell *sh, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    shell_vprint("error: ", fmt, args);
+    va_end(args);
+}
+
+static const struct shell_static_entry *find_cmd(const struct shell_static_entry *set, size_t len,
+                                                 const char *syntax) {
+    for (size_t i = 0; i < len && set[i].syntax; i++) {
+        if (strcmp(set[i].syntax, syntax) == 0) {
+            return &set[i];
+        }
+    }
+    return NULL;
+}
+
+int harness_shell_exec(const char *line) {
+    char buf[128];
+    char *argv[MAX_SHELL_ARGS];
+    size_t argc = 0;
+
+    snprintf(buf, sizeof(buf), "%s", line);
+    for (char *tok = strtok(buf, " "); tok && argc < MAX_SHELL_ARGS; tok = strtok(NULL, " ")) {
+        argv[argc++] = tok;
+    }
+    printf("> %s\n", line);
+
+    const struct shell_static_entry *cmd = NULL;
+    for (size_t i = 0; i < shell_cmds_count && argc; i++) {
+        if (strcmp(shell_cmds[i]->syntax, argv[0]) == 0) {
+            cmd = shell_cmds[i];
+        }
+    }
+    // descend into subcommands, the handler gets its own name and the remaining words
+    size_t depth = 0;
+    while (cmd && cmd->subcmd && depth + 1 < argc) {
+        const struct shell_static_entry *sub = find_cmd(cmd->subcmd, SIZE_MAX, argv[depth + 1]);
+        if (!sub) {
+            break;
+        }
+        cmd = sub;
+        depth++;
+    }
+    if (!cmd || !cmd->handler) {
+        shell_error(&harness_shell, "%s: command not found", line);
+        return -ENOEXEC;
+    }
+    size_t args = argc - depth;
+    // as in Zephyr, the command itself is one of the mandatory arguments and a command
+    // without any does not check its arguments
+    if (cmd->mandatory && (args < cmd->mandatory || args > cmd->mandatory + cmd->optional)) {
+        shell_error(&harness_shell, "%s: wrong parameter count", line);
+        return -EINVAL;
+    }
+    return cmd->handler(&harness_shell, args, &argv[depth]);
+}
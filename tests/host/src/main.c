@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host harness of the input behavior listener. Runs the module sources against the
+// board of the build, feeding synthetic or recorded input streams through the input
+// device and printing the mouse reports and layer changes they produce, or the events
+// a split peripheral build forwards.
+//
+// Arguments are run in order:
+//   --stream=<sweep|flick|jitter|scroll|buttons|touch|stick|burst|all>  synthetic input stream
+//   --csv=<file>     raw events of an input_listener record dump
+//   --shell=<cmd>    shell command, e.g. --shell="input_listener record start"
+//   --hires=<n>      resolution multiplier the host enabled for both wheels, 1 to 16
+//   --idle=<ms>      let the virtual clock run
+//   --bench=<n>      time n frames of the sweep stream, without printing reports
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/input/input.h>
+#include <zephyr/dt-bindings/input/input-event-codes.h>
+
+#include <zmk/keymap.h>
+
+#include <harness.h>
+
+DEVICE_DT_DEFINE(HARNESS_INPUT_NODE, NULL, NULL, NULL, NULL, POST_KERNEL, 50, NULL);
+
+static const struct device *const input_dev = DEVICE_DT_GET(HARNESS_INPUT_NODE);
+
+// gap between the parts of the "all" stream, longer than any layer time to live
+#define STREAM_GAP_MS 400
+
+static int64_t now_ms(void) { return k_uptime_get(); }
+
+static void frame(int64_t t, int32_t dx, int32_t dy) {
+    harness_advance_to(t);
+    if (dx) {
+        input_report_rel(input_dev, INPUT_REL_X, dx, !dy, K_FOREVER);
+    }
+    if (dy) {
+        input_report_rel(input_dev, INPUT_REL_Y, dy, true, K_FOREVER);
+    }
+}
+
+static void button(int64_t t, uint16_t code, int32_t value) {
+    harness_advance_to(t);
+    input_report_key(input_dev, code, value, true, K_FOREVER);
+}
+
+// events other devices report, i.e. the frames a split peripheral build forwards,
+// printed one line per sync
+static void print_forwarded(struct input_event *evt) {
+    static const char *const rel_names[] = {
+        [INPUT_REL_X] = "x", [INPUT_REL_Y] = "y", [INPUT_REL_HWHEEL] = "h", [INPUT_REL_WHEEL] = "v",
+    };
+    static bool line_open;
+
+    if (evt->dev == input_dev || !harness_print_reports) {
+        return;
+    }
+    if (!line_open) {
+        printf("%6lld: %s", (long long)now_ms(), evt->dev->name);
+        line_open = true;
+    }
+    if (evt->type == INPUT_EV_REL && evt->code < ARRAY_SIZE(rel_names) && rel_names[evt->code]) {
+        printf(" %s=%d", rel_names[evt->code], evt->value);
+    } else if (evt->type == INPUT_EV_KEY && evt->code >= INPUT_BTN_0) {
+        printf(" button%d=%d", evt->code - INPUT_BTN_0, evt->value);
+    } else {
+        printf(" type%u/code%u=%d", evt->type, evt->code, evt->value);
+    }
+    if (evt->sync) {
+        putchar('\n');
+        line_open = false;
+    }
+}
+
+INPUT_CALLBACK_DEFINE(NULL, print_forwarded);
+
+// a circle of 16 steps
+static const int8_t circle[] = {6, 6, 5, 4, 2, 0, -2, -4, -5, -6, -6, -5, -4, -2, 0, 2};
+
+static void stream_sweep(int64_t t) {
+    for (int i = 0; i < 128; i++) {
+        frame(t + i, circle[i % 16], circle[(i + 4) % 16]);
+    }
+}
+
+// a flick speeds up to well past the acceleration range and slows down again
+static void stream_flick(int64_t t) {
+    static const int16_t speed[] = {1,   2,   3,   5,   8,   13, 21, 34, 55, 89, 144,
+                                    233, 233, 144, 89,  55,  34, 21, 13, 8,  5,  3,
+                                    2,   1,   1,   1};
+    for (int i = 0; i < (int)ARRAY_SIZE(speed); i++) {
+        frame(t + i, speed[i], -speed[i] / 3);
+    }
+}
+
+// sensor noise at rest, then a slow drift
+static void stream_jitter(int64_t t) {
+    uint32_t lcg = 12345;
+    for (int i = 0; i < 100; i++) {
+        lcg = lcg * 1103515245 + 12345;
+        int32_t dx = (int32_t)((lcg >> 16) % 3) - 1;
+        int32_t dy = (int32_t)((lcg >> 20) % 3) - 1;
+        if (i >= 60) {
+            dx += 1;
+        }
+        if (dx || dy) {
+            frame(t + 2 * i, dx, dy);
+        }
+    }
+}
+
+// scroll on layer 2, slowly and then fast enough to span several detents per frame
+static void stream_scroll(int64_t t) {
+    harness_advance_to(t);
+    zmk_keymap_layer_activate(2);
+    for (int i = 0; i < 60; i++) {
+        frame(t + 2 * i + 1, i % 5 == 0, i < 30 ? 1 : 6);
+    }
+    harness_advance_to(t + 130);
+    zmk_keymap_layer_deactivate(2);
+}
+
+// clicks in their own frames and in the middle of a motion frame
+static void stream_buttons(int64_t t) {
+    button(t, INPUT_BTN_0, 1);
+    frame(t + 1, 3, 1);
+    frame(t + 2, 3, 1);
+    button(t + 3, INPUT_BTN_0, 0);
+
+    harness_advance_to(t + 20);
+    input_report_rel(input_dev, INPUT_REL_X, 4, false, K_FOREVER);
+    input_report_key(input_dev, INPUT_BTN_1, 1, false, K_FOREVER);
+    input_report_rel(input_dev, INPUT_REL_Y, -2, true, K_FOREVER);
+    frame(t + 21, 2, 0);
+    harness_advance_to(t + 40);
+    input_report_key(input_dev, INPUT_BTN_1, 0, false, K_FOREVER);
+    input_report_rel(input_dev, INPUT_REL_X, -1, true, K_FOREVER);
+}
+
+// a high CPI sensor whose driver batches a fast flick, four events of one axis in a
+// single frame that sum far beyond the HID range
+static void stream_burst(int64_t t) {
+    harness_advance_to(t);
+    for (int i = 0; i < 4; i++) {
+        input_report_rel(input_dev, INPUT_REL_X, 30000, i == 3, K_FOREVER);
+    }
+}
+
+static void touch_position(int64_t t, int32_t x, int32_t y) {
+    harness_advance_to(t);
+    input_report_abs(input_dev, INPUT_ABS_X, x, false, K_FOREVER);
+    input_report_abs(input_dev, INPUT_ABS_Y, y, true, K_FOREVER);
+}
+
+// two strokes on a touchpad, the second starting far away from where the first ended
+static void stream_touch(int64_t t) {
+    harness_advance_to(t);
+    input_report_key(input_dev, INPUT_BTN_TOUCH, 1, false, K_FOREVER);
+    touch_position(t, 100, 200);
+    for (int i = 1; i <= 20; i++) {
+        touch_position(t + i, 100 + 7 * i, 200 - 3 * i);
+    }
+    button(t + 21, INPUT_BTN_TOUCH, 0);
+
+    harness_advance_to(t + 40);
+    input_report_key(input_dev, INPUT_BTN_TOUCH, 1, false, K_FOREVER);
+    touch_position(t + 40, 600, 50);
+    // only X changes in these frames
+    for (int i = 1; i <= 10; i++) {
+        harness_advance_to(t + 40 + i);
+        input_report_abs(input_dev, INPUT_ABS_X, 600 - 5 * i, true, K_FOREVER);
+    }
+    button(t + 51, INPUT_BTN_TOUCH, 0);
+}
+
+// a joystick centered at 512, held right, then right and up, then let go
+static void stream_stick(int64_t t) {
+    touch_position(t, 512, 512);
+    touch_position(t + 5, 700, 512);
+    touch_position(t + 35, 700, 400);
+    touch_position(t + 60, 520, 505);
+}
+
+// "all" runs the relative streams, touch, stick and burst only run when named
+static const struct {
+    const char *name;
+    void (*run)(int64_t t);
+    bool all;
+} streams[] = {
+    {"sweep", stream_sweep, true},     {"flick", stream_flick, true},
+    {"jitter", stream_jitter, true},   {"scroll", stream_scroll, true},
+    {"buttons", stream_buttons, true}, {"touch", stream_touch, false},
+    {"stick", stream_stick, false},    {"burst", stream_burst, false},
+};
+
+static int run_stream(const char *name) {
+    bool all = strcmp(name, "all") == 0;
+    bool found = false;
+    for (size_t i = 0; i < ARRAY_SIZE(streams); i++) {
+        if ((all && streams[i].all) || strcmp(name, streams[i].name) == 0) {
+            printf("# stream %s\n", streams[i].name);
+            streams[i].run(now_ms() + 10);
+            harness_advance_to(now_ms() + STREAM_GAP_MS);
+            found = true;
+        }
+    }
+    if (!found) {
+        fprintf(stderr, "unknown stream %s\n", name);
+        return -EINVAL;
+    }
+    return 0;
+}
+
+// Replay the raw events of a capture, in the CSV format of "input_listener record dump".
+static int run_csv(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -ENOENT;
+    }
+
+    printf("# capture %s\n", strrchr(path, '/') ? strrchr(path, '/') + 1 : path);
+    int64_t start = now_ms() + 10;
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        unsigned int time_us, type, code, sync;
+        int listener, value;
+        char stage[16];
+        if (sscanf(line, "%u,%d,%15[a-z],%u,%u,%d,%u", &time_us, &listener, stage, &type, &code,
+                   &value, &sync) != 7 ||
+            strcmp(stage, "raw") != 0) {
+            continue;
+        }
+        harness_advance_to(start + time_us / 1000);
+        input_report(input_dev, type, code, value, sync, K_FOREVER);
+    }
+    fclose(f);
+    harness_advance_to(now_ms() + STREAM_GAP_MS);
+    return 0;
+}
+
+static int cycles_cmp(const void *a, const void *b) {
+    uint32_t ca = *(const uint32_t *)a, cb = *(const uint32_t *)b;
+    return ca < cb ? -1 : ca > cb;
+}
+
+// Cycles of each frame of the sweep stream, from its first event to the end of the
+// report work it leads to. The median is printed along with the mean, as the mean
+// picks up interrupts and preemption of the host.
+static int run_bench(int frames) {
+    uint32_t *cycles = calloc(frames, sizeof(*cycles));
+    if (!cycles || frames <= 0) {
+        free(cycles);
+        return -EINVAL;
+    }
+
+    bool print_reports = harness_print_reports;
+    harness_print_reports = false;
+    uint32_t reports = harness_reports;
+    int64_t t = now_ms() + 10;
+    uint64_t total = 0;
+    for (int i = 0; i < frames; i++) {
+        harness_advance_to(t + i);
+        uint32_t start = k_cycle_get_32();
+        input_report_rel(input_dev, INPUT_REL_X, circle[i % 16], false, K_FOREVER);
+        input_report_rel(input_dev, INPUT_REL_Y, circle[(i + 4) % 16], true, K_FOREVER);
+        harness_advance_to(t + i + 1);
+        cycles[i] = k_cycle_get_32() - start;
+        total += cycles[i];
+    }
+    harness_advance_to(now_ms() + STREAM_GAP_MS);
+    harness_print_reports = print_reports;
+
+    // every frame is two events, X and Y with sync
+    qsort(cycles, frames, sizeof(*cycles), cycles_cmp);
+    printf("bench: %d frames, %u reports, cycles/frame median %u mean %u, %llu events/s\n",
+           frames, harness_reports - reports, cycles[frames / 2], (uint32_t)(total / frames),
+           (unsigned long long)(2ull * frames * sys_clock_hw_cycles_per_sec() / MAX(total, 1)));
+    free(cycles);
+    return 0;
+}
+
+static const char *arg_value(const char *arg, const char *name) {
+    size_t len = strlen(name);
+    return strncmp(arg, name, len) == 0 && arg[len] == '=' ? &arg[len + 1] : NULL;
+}
+
+int main(int argc, char **argv) {
+    int ret = harness_init();
+    if (ret < 0) {
+        return 1;
+    }
+
+    for (int i = 1; i < argc && ret >= 0; i++) {
+        const char *value;
+        if ((value = arg_value(argv[i], "--stream"))) {
+            ret = run_stream(value);
+        } else if ((value = arg_value(argv[i], "--csv"))) {
+            ret = run_csv(value);
+        } else if ((value = arg_value(argv[i], "--shell"))) {
+            // a failing command prints its error into the output, which the baseline checks
+            harness_shell_exec(value);
+        } else if ((value = arg_value(argv[i], "--hires"))) {
+            uint8_t mul = CLAMP(atoi(value), 1, 16) - 1;
+            harness_resolution_multipliers.wheel = mul;
+            harness_resolution_multipliers.hor_wheel = mul;
+        } else if ((value = arg_value(argv[i], "--idle"))) {
+            harness_advance_to(now_ms() + atoi(value));
+        } else if ((value = arg_value(argv[i], "--bench"))) {
+            ret = run_bench(atoi(value));
+        } else {
+            fprintf(stderr, "unknown argument %s\n", argv[i]);
+            ret = -EINVAL;
+        }
+    }
+
+    // let pending reports and layer timeouts run out
+    harness_advance_to(now_ms() + 1000);
+    return ret < 0 ? 1 : 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Keymap layers, event manager, behaviors and the mouse HID endpoint of the host harness.
+// Layer changes and mouse reports are printed to stdout, one line each.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+
+#include <zmk/behavior.h>
+#include <zmk/endpoints.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/layer_state_changed.h>
+#include <zmk/hid.h>
+#include <zmk/keymap.h>
+#include <zmk/mouse/resolution_multipliers.h>
+
+#include <harness.h>
+
+bool harness_print_reports = true;
+uint32_t harness_reports;
+struct zmk_mouse_resolution_multipliers harness_resolution_multipliers;
+
+// event manager
+
+ZMK_EVENT_IMPL(zmk_layer_state_changed);
+
+static struct zmk_event_subscription *subscriptions;
+
+void z_zmk_event_subscribe(struct zmk_event_subscription *sub) {
+    struct zmk_event_subscription **tail = &subscriptions;
+    while (*tail) {
+        tail = &(*tail)->next;
+    }
+    *tail = sub;
+}
+
+int z_zmk_event_raise(const zmk_event_t *eh) {
+    for (struct zmk_event_subscription *sub = subscriptions; sub; sub = sub->next) {
+        if (sub->event_type != eh->event) {
+            continue;
+        }
+        int ret = sub->listener->callback(eh);
+        if (ret != ZMK_EV_EVENT_BUBBLE) {
+            return ret;
+        }
+    }
+    return 0;
+}
+
+// keymap, the default layer 0 is always active
+
+static zmk_keymap_layers_state_t layer_state = BIT(0);
+
+zmk_keymap_layers_state_t zmk_keymap_layer_state(void) { return layer_state; }
+
+bool zmk_keymap_layer_active(uint8_t layer) { return (layer_state & BIT(layer)) != 0; }
+
+uint8_t zmk_keymap_highest_layer_active(void) {
+    for (uint8_t layer = ZMK_KEYMAP_LAYERS_LEN - 1; layer > 0; layer--) {
+        if (zmk_keymap_layer_active(layer)) {
+            return layer;
+        }
+    }
+    return 0;
+}
+
+static int set_layer_state(uint8_t layer, bool state) {
+    if (layer >= ZMK_KEYMAP_LAYERS_LEN || layer == 0) {
+        return -EINVAL;
+    }
+    if (zmk_keymap_layer_active(layer) == state) {
+        return 0;
+    }
+    if (state) {
+        layer_state |= BIT(layer);
+    } else {
+        layer_state &= ~BIT(layer);
+    }
+    if (harness_print_reports) {
+        printf("%6lld: layer %u %s\n", (long long)k_uptime_get(), layer, state ? "on" : "off");
+    }
+    return raise_zmk_layer_state_changed((struct zmk_layer_state_changed){
+        .layer = layer, .state = state, .timestamp = k_uptime_get()});
+}
+
+int zmk_keymap_layer_activate(uint8_t layer) { return set_layer_state(layer, true); }
+
+int zmk_keymap_layer_deactivate(uint8_t layer) { return set_layer_state(layer, false); }
+
+int zmk_keymap_layer_toggle(uint8_t layer) {
+    return set_layer_state(layer, !zmk_keymap_layer_active(layer));
+}
+
+// behaviors
+
+const struct device *zmk_behavior_get_binding(const char *name) {
+    return device_get_binding(name);
+}
+
+// mouse HID
+
+static struct {
+    int16_t x;
+    int16_t y;
+    int16_t scroll_x;
+    int16_t scroll_y;
+    uint8_t buttons;
+} mouse_report;
+
+void zmk_hid_mouse_movement_set(int16_t x, int16_t y) {
+    mouse_report.x = x;
+    mouse_report.y = y;
+}
+
+void zmk_hid_mouse_scroll_set(int16_t x, int16_t y) {
+    mouse_report.scroll_x = x;
+    mouse_report.scroll_y = y;
+}
+
+int zmk_hid_mouse_button_press(uint8_t button) {
+    mouse_report.buttons |= BIT(button);
+    return 0;
+}
+
+int zmk_hid_mouse_button_release(uint8_t button) {
+    mouse_report.buttons &= ~BIT(button);
+    return 0;
+}
+
+int zmk_endpoints_send_mouse_report(void) {
+    harness_reports++;
+    if (harness_print_reports) {
+        printf("%6lld: x=%d y=%d h=%d v=%d buttons=0x%02x\n", (long long)k_uptime_get(),
+               mouse_report.x, mouse_report.y, mouse_report.scroll_x, mouse_report.scroll_y,
+               mouse_report.buttons);
+    }
+    return 0;
+}
+
+struct zmk_mouse_resolution_multipliers zmk_mouse_resolution_multipliers_get_current_profile(void) {
+    return harness_resolution_multipliers;
+}